@@ -0,0 +1,177 @@
+/*!
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/* Time the loading of a large number of objects from xml and their
+   deletion, and count the heap allocations made by each load.
+
+   Usage: ExampleLoadBenchmark [number of customers] [number of runs]
+
+   This benchmark was used to evaluate a pool allocator for the
+   ValueObjects and ObjectWrappers created on load.  With 100000
+   customers and 100000 accounts, loads took 11.1-12.1 s from the heap
+   and 10.7-12.3 s from the pool over three runs, and deleteAllObjects
+   was about 70 ms faster with the pool.  Loading is dominated by xml
+   parsing, so the pool brought no measurable gain and was not kept.
+*/
+
+#ifdef BOOST_MSVC
+#  define BOOST_LIB_DIAGNOSTIC
+#  include <oh/auto_link.hpp>
+#  undef BOOST_LIB_DIAGNOSTIC
+#endif
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <exception>
+#include <oh/objecthandler.hpp>
+#include <ExampleObjects/accountexample.hpp>
+#include <Examples/ExampleObjects/Serialization/serializationfactory.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+// Count every allocation made by the program.
+namespace {
+    std::size_t allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) throw() {
+    std::free(p);
+}
+
+namespace {
+
+    double now() {
+        return (boost::posix_time::microsec_clock::universal_time() -
+                boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1)))
+            .total_microseconds() * 1.0e-6;
+    }
+
+    void makeCustomer(const std::string &objectID, const std::string &name, long age) {
+        boost::shared_ptr<ObjectHandler::ValueObject> valueObject(
+            new AccountExample::CustomerValueObject(objectID, name, age, false));
+        boost::shared_ptr<ObjectHandler::Object> object(
+            new AccountExample::CustomerObject(valueObject, name, age, false));
+        ObjectHandler::Repository::instance().storeObject(objectID, object, true);
+    }
+
+    void makeAccount(const std::string &objectID, const std::string &customer, long number) {
+        OH_GET_REFERENCE(customerRef, customer,
+            AccountExample::CustomerObject, AccountExample::Customer)
+        boost::shared_ptr<ObjectHandler::ValueObject> valueObject(
+            new AccountExample::AccountValueObject(
+                objectID, customer, "Savings", number, 100.0, false));
+        boost::shared_ptr<ObjectHandler::Object> object(
+            new AccountExample::AccountObject(
+                valueObject, customerRef, AccountExample::Account::Savings,
+                number, 100.0, false));
+        ObjectHandler::Repository::instance().storeObject(objectID, object, true);
+    }
+
+    void load(const std::string &xml, std::size_t run, std::size_t expected) {
+        ObjectHandler::Repository::instance().deleteAllObjects();
+
+        std::size_t before = allocations;
+        double start = now();
+        std::size_t loaded =
+            ObjectHandler::SerializationFactory::instance().loadObjectString(xml, true).size();
+        double elapsed = now() - start;
+        std::size_t count = allocations - before;
+        OH_REQUIRE(loaded == expected,
+            "loaded " << loaded << " objects instead of " << expected);
+
+        start = now();
+        ObjectHandler::Repository::instance().deleteAllObjects();
+        double deleted = now() - start;
+
+        std::cout << std::setw(6) << run
+                  << std::setw(12) << std::fixed << std::setprecision(3) << elapsed
+                  << std::setw(12) << deleted
+                  << std::setw(14) << count
+                  << std::setw(12) << std::setprecision(1)
+                  << double(count) / expected << std::endl;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+
+    ObjectHandler::Repository repository;
+    ObjectHandler::EnumTypeRegistry enumTypeRegistry;
+    ObjectHandler::ProcessorFactory processorFactory;
+    AccountExample::SerializationFactory factory;
+
+    try {
+
+        std::size_t customers = argc > 1 ? std::atol(argv[1]) : 100000;
+        OH_REQUIRE(customers > 0, "invalid number of customers: " << argv[1]);
+        std::size_t runs = argc > 2 ? std::atol(argv[2]) : 3;
+        OH_REQUIRE(runs > 0, "invalid number of runs: " << argv[2]);
+
+        AccountExample::registerEnumeratedTypes();
+
+        // One account per customer; customers are saved before the
+        // accounts depending on them.
+        std::vector<boost::shared_ptr<ObjectHandler::Object> > objects;
+        for (std::size_t i = 0; i < customers; ++i) {
+            std::ostringstream id;
+            id << "customer" << i;
+            makeCustomer(id.str(), "Joe", 40);
+            OH_GET_OBJECT(customer, id.str(), ObjectHandler::Object)
+            objects.push_back(customer);
+        }
+        for (std::size_t i = 0; i < customers; ++i) {
+            std::ostringstream id, customer;
+            id << "account" << i;
+            customer << "customer" << i;
+            makeAccount(id.str(), customer.str(), long(i));
+            OH_GET_OBJECT(account, id.str(), ObjectHandler::Object)
+            objects.push_back(account);
+        }
+        std::string xml =
+            ObjectHandler::SerializationFactory::instance().saveObjectString(objects, true);
+        std::size_t expected = objects.size();
+        objects.clear();
+
+        std::cout << expected << " objects" << std::endl
+                  << std::setw(6) << "run"
+                  << std::setw(12) << "load (s)"
+                  << std::setw(12) << "delete (s)"
+                  << std::setw(14) << "allocations"
+                  << std::setw(12) << "per object" << std::endl;
+        for (std::size_t i = 1; i <= runs; ++i)
+            load(xml, i, expected);
+
+        return 0;
+
+    } catch (const std::exception &e) {
+
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+
+    } catch (...) {
+
+        std::cout << "Error" << std::endl;
+        return 1;
+
+    }
+}
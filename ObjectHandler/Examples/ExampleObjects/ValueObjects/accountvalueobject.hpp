@@ -48,6 +48,7 @@ namespace AccountExample {
         const std::set<std::string>& getSystemPropertyNames() const;
         std::vector<std::string> getPropertyNamesVector() const;
         ObjectHandler::property_t getSystemProperty(const std::string &name) const;
+        using ObjectHandler::ValueObject::getSystemProperty;
         void setSystemProperty(const std::string& name, const ObjectHandler::property_t& value);
 
     private:
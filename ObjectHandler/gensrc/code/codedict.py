@@ -175,48 +175,37 @@ code65 = '''\
 ##########################################################################
 
 code66 = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
             return %(name)s_;\n'''
 
 code66a = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
             return %(name)s_;\n'''
 
 code67a = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
             %(name)s_ = value;\n'''
 
 code67b = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
             %(name)s_ = ObjectHandler::convert2<std::string>(value);\n'''
 
 code67c = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
             %(name)s_ = ObjectHandler::convert2<%(nativeType)s>(value);\n'''
 
 code67d = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::vector::convert2<ObjectHandler::property_t>(value, nameUpper);\n'''
+            %(name)s_ = ObjectHandler::vector::convert2<ObjectHandler::property_t>(value, "%(name)s");\n'''
 
 code67e = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::vector::convert2<std::string>(value, nameUpper);\n'''
+            %(name)s_ = ObjectHandler::vector::convert2<std::string>(value, "%(name)s");\n'''
 
 code67f = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::vector::convert2<%(nativeType)s>(value, nameUpper);\n'''
+            %(name)s_ = ObjectHandler::vector::convert2<%(nativeType)s>(value, "%(name)s");\n'''
 
 code67g = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::matrix::convert2<ObjectHandler::property_t>(value, nameUpper);\n'''
+            %(name)s_ = ObjectHandler::matrix::convert2<ObjectHandler::property_t>(value, "%(name)s");\n'''
 
 code67h = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::matrix::convert2<std::string>(value, nameUpper);\n'''
+            %(name)s_ = ObjectHandler::matrix::convert2<std::string>(value, "%(name)s");\n'''
 
 code67i = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::matrix::convert2<%(nativeType)s>(value, nameUpper);\n'''
+            %(name)s_ = ObjectHandler::matrix::convert2<%(nativeType)s>(value, "%(name)s");\n'''
 
 code69 = '''\
             processPrecedentID(%(name)s);'''
@@ -24,6 +24,7 @@
 #include <oh/object.hpp>
 #include <oh/libraryobject.hpp>
 #include <oh/repository.hpp>
+#include <oh/scenario.hpp>
 #include <oh/utilities.hpp>
 #include <oh/exception.hpp>
 #include <oh/property.hpp>
@@ -86,6 +86,10 @@ namespace ObjectHandler {
         /*! False means the Object is up to date, true means it is invalid.
         */
         bool dirty() const { return dirty_; }
+        //! Number of times the contained Object was replaced.
+        /*! Lets the Repository detect stale references to the Object.
+        */
+        unsigned long version() const { return version_; }
         //@}
 
         //! \name Logging
@@ -105,10 +109,12 @@ namespace ObjectHandler {
         double creationTime_;
         // Time at which Object was last recreated.
         double updateTime_;
+        // Incremented whenever object_ is replaced.
+        unsigned long version_;
     };
 
     inline ObjectWrapper::ObjectWrapper(const boost::shared_ptr<Object>& object)
-        : object_(object), dirty_(false) {
+        : object_(object), dirty_(false), version_(0) {
             creationTime_ = updateTime_ = getTime();
     }
 
@@ -116,6 +122,7 @@ namespace ObjectHandler {
         try {
             object_ = SerializationFactory::instance().recreateObject( 
                 object_->properties());
+            ++version_;
             dirty_ = false;
             updateTime_ = getTime();
         } catch (const std::exception &e) {
@@ -130,6 +137,7 @@ namespace ObjectHandler {
 
     inline void ObjectWrapper::reset(boost::shared_ptr<Object> object) {
         object_ = object;
+        ++version_;
         dirty_ = false;
         updateTime_ = getTime();
         notifyObservers();
@@ -28,16 +28,23 @@
 
 #include <oh/exception.hpp>
 
+#include <boost/container/small_vector.hpp>
 #include <boost/shared_ptr.hpp>
 
-#include <set>
+#include <algorithm>
+#include <vector>
 
 namespace ObjectHandler {
 
     class Observer;
 
     //! Object that notifies its changes to a set of observers
-    /*! \ingroup patterns */
+    /*! Observers are kept in a flat list, in no particular order; each
+        observer knows its position in the list, so that it can be
+        unregistered in constant time.
+
+        \ingroup patterns
+    */
     class Observable {
         friend class Observer;
       public:
@@ -51,15 +58,20 @@ namespace ObjectHandler {
         */
         void notifyObservers();
       private:
-        typedef std::set<Observer*>::iterator iterator;
-        std::pair<iterator, bool> registerObserver(Observer*);
-        size_t unregisterObserver(Observer*);
-        std::set<Observer*> observers_;
+        std::size_t registerObserver(Observer*);
+        void unregisterObserver(std::size_t position);
+        boost::container::small_vector<Observer*, 4> observers_;
     };
 
     //! Object that gets notified when a given observable changes
-    /*! \ingroup patterns */
+    /*! Most observers observe a handful of observables, which are kept
+        inline together with the position of the observer in the list of
+        each of them.
+
+        \ingroup patterns
+    */
     class Observer {
+        friend class Observable;
       public:
         // constructors, assignment, destructor
         Observer() {}
@@ -67,19 +79,42 @@ namespace ObjectHandler {
         Observer& operator=(const Observer&);
         virtual ~Observer();
         // observer interface
-        std::pair<std::set<boost::shared_ptr<Observable> >::iterator, bool>
-                            registerWith(const boost::shared_ptr<Observable>&);
+        //! Returns false if already registered with the given observable.
+        bool registerWith(const boost::shared_ptr<Observable>&);
         size_t unregisterWith(const boost::shared_ptr<Observable>&);
+        void unregisterWithAll();
+        //! Register with the given observables only.
+        /*! Links to the observables already registered with are kept, so
+            that only those which changed are touched.
+        */
+        void registerWithOnly(
+                const std::vector<boost::shared_ptr<Observable> >& observables);
+        //! Number of observables registered with.
+        std::size_t observableCount() const { return observables_.size(); }
+        //! The i-th observable registered with, in no particular order.
+        const boost::shared_ptr<Observable>& observable(std::size_t i) const {
+            return observables_[i].observable;
+        }
         /*! This method must be implemented in derived classes. An
             instance of %Observer does not call this method directly:
             instead, it will be called by the observables the instance
             registered with when they need to notify any changes.
         */
-        void unregisterWithAll();
         virtual void update() = 0;
       private:
-        std::set<boost::shared_ptr<Observable> > observables_;
-        typedef std::set<boost::shared_ptr<Observable> >::iterator iterator;
+        struct Link {
+            Link(const boost::shared_ptr<Observable>& o, std::size_t p)
+            : observable(o), position(p) {}
+            boost::shared_ptr<Observable> observable;
+            // position of this observer in the observable's list
+            std::size_t position;
+        };
+        typedef boost::container::small_vector<Link, 4> Links;
+        Links::iterator find(const Observable*);
+        // called by an observable which moved this observer in its list
+        void relocate(const Observable*, std::size_t position);
+        void registerWithAll(const Links&);
+        Links observables_;
     };
 
 
@@ -106,21 +141,27 @@ namespace ObjectHandler {
         return *this;
     }
 
-    inline std::pair<std::set<Observer*>::iterator, bool>
-    Observable::registerObserver(Observer* o) {
-        return observers_.insert(o);
+    inline std::size_t Observable::registerObserver(Observer* o) {
+        observers_.push_back(o);
+        return observers_.size() - 1;
     }
 
-    inline size_t Observable::unregisterObserver(Observer* o) {
-        return observers_.erase(o);
+    inline void Observable::unregisterObserver(std::size_t position) {
+        // move the last observer in the freed slot
+        Observer* last = observers_.back();
+        observers_.pop_back();
+        if (position < observers_.size()) {
+            observers_[position] = last;
+            last->relocate(this, position);
+        }
     }
 
     inline void Observable::notifyObservers() {
         bool successful = true;
         std::string errMsg;
-        for (iterator i=observers_.begin(); i!=observers_.end(); ++i) {
+        for (std::size_t i=0; i<observers_.size(); ++i) {
             try {
-                (*i)->update();
+                observers_[i]->update();
             } catch (std::exception& e) {
                 // quite a dilemma. If we don't catch the exception,
                 // other observers will not receive the notification
@@ -140,49 +181,104 @@ namespace ObjectHandler {
     }
 
 
-    inline Observer::Observer(const Observer& o)
-    : observables_(o.observables_) {
-        for (iterator i=observables_.begin(); i!=observables_.end(); ++i)
-            (*i)->registerObserver(this);
+    inline Observer::Observer(const Observer& o) {
+        registerWithAll(o.observables_);
     }
 
     inline Observer& Observer::operator=(const Observer& o) {
-        iterator i;
-        for (i=observables_.begin(); i!=observables_.end(); ++i)
-            (*i)->unregisterObserver(this);
-        observables_ = o.observables_;
-        for (i=observables_.begin(); i!=observables_.end(); ++i)
-            (*i)->registerObserver(this);
+        if (&o != this) {
+            Links observables(o.observables_);
+            unregisterWithAll();
+            registerWithAll(observables);
+        }
         return *this;
     }
 
     inline Observer::~Observer() {
-        for (iterator i=observables_.begin(); i!=observables_.end(); ++i)
-            (*i)->unregisterObserver(this);
+        unregisterWithAll();
     }
 
-    inline std::pair<std::set<boost::shared_ptr<Observable> >::iterator, bool>
-    Observer::registerWith(const boost::shared_ptr<Observable>& h) {
-        if (h) {
-            h->registerObserver(this);
-            return observables_.insert(h);
-        }
-        return std::make_pair(observables_.end(), false);
+    inline Observer::Links::iterator Observer::find(const Observable* h) {
+        Links::iterator i = observables_.begin();
+        while (i != observables_.end() && i->observable.get() != h)
+            ++i;
+        return i;
+    }
+
+    inline void Observer::relocate(const Observable* h, std::size_t position) {
+        find(h)->position = position;
+    }
+
+    inline void Observer::registerWithAll(const Links& observables) {
+        observables_.reserve(observables.size());
+        for (Links::const_iterator i=observables.begin(); i!=observables.end(); ++i)
+            observables_.push_back(
+                Link(i->observable, i->observable->registerObserver(this)));
+    }
+
+    inline bool Observer::registerWith(const boost::shared_ptr<Observable>& h) {
+        if (!h || find(h.get()) != observables_.end())
+            return false;
+        observables_.push_back(Link(h, h->registerObserver(this)));
+        return true;
     }
 
     inline
     size_t Observer::unregisterWith(const boost::shared_ptr<Observable>& h) {
-        if (h)
-            h->unregisterObserver(this);
-        return observables_.erase(h);
+        Links::iterator i = find(h.get());
+        if (!h || i == observables_.end())
+            return 0;
+        h->unregisterObserver(i->position);
+        *i = observables_.back();
+        observables_.pop_back();
+        return 1;
     }
 
     inline void Observer::unregisterWithAll() {
-        for (iterator i=observables_.begin(); i!=observables_.end(); ++i)
-            (*i)->unregisterObserver(this);
+        for (Links::iterator i=observables_.begin(); i!=observables_.end(); ++i)
+            i->observable->unregisterObserver(i->position);
         observables_.clear();
     }
 
+    inline void Observer::registerWithOnly(
+                const std::vector<boost::shared_ptr<Observable> >& observables) {
+        // wanted observables, with their index in the given vector; the
+        // index is cleared for those already registered with
+        typedef std::pair<Observable*, std::size_t> Entry;
+        const std::size_t registered = observables.size();
+        std::vector<Entry> wanted;
+        wanted.reserve(observables.size());
+        for (std::size_t i=0; i<observables.size(); ++i) {
+            if (observables[i])
+                wanted.push_back(Entry(observables[i].get(), i));
+        }
+        std::sort(wanted.begin(), wanted.end());
+
+        // drop the links which are no longer wanted...
+        for (std::size_t i=0; i<observables_.size(); ) {
+            Observable* h = observables_[i].observable.get();
+            std::vector<Entry>::iterator j =
+                std::lower_bound(wanted.begin(), wanted.end(), Entry(h, 0));
+            if (j != wanted.end() && j->first == h) {
+                j->second = registered;
+                ++i;
+            } else {
+                h->unregisterObserver(observables_[i].position);
+                observables_[i] = observables_.back();
+                observables_.pop_back();
+            }
+        }
+
+        // ...and add the missing ones, once each
+        for (std::size_t j=0; j<wanted.size(); ++j) {
+            if (wanted[j].second == registered ||
+                (j > 0 && wanted[j].first == wanted[j-1].first))
+                continue;
+            observables_.push_back(Link(observables[wanted[j].second],
+                                        wanted[j].first->registerObserver(this)));
+        }
+    }
+
 }
 
 #endif
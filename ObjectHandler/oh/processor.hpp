@@ -26,6 +26,7 @@
 #define oh_processor_hpp
 
 #include <map>
+#include <set>
 #include <string>
 #include <list>
 
@@ -79,6 +80,27 @@ namespace ObjectHandler {
         */
         virtual void postProcess() const = 0;
         //@}
+
+        //! \name Recreation
+        //@{
+        //! IDs of the Objects attached to the given Object after construction.
+        /*! Member functions such as those setting a pricing engine record
+            the IDs they attach as user properties rather than precedents.
+            A Scenario recreates the Object when one of them is overridden,
+            just as when one of its precedents is.
+        */
+        virtual std::set<std::string> memberPrecedents(
+            const boost::shared_ptr<ValueObject>&) const {
+                return std::set<std::string>();
+        }
+        //! Re-apply to a recreated Object the state set after its construction.
+        /*! Called by process() after deserialization, and by the Repository
+            after recreating an Object within a Scenario.  The default does
+            nothing.
+        */
+        virtual void restore(const boost::shared_ptr<ValueObject>&,
+                             const boost::shared_ptr<Object>&) const {}
+        //@}
     };
 
     //! Default behavior for post serialization processing of an Object.
@@ -24,10 +24,16 @@
 #endif
 
 #include <oh/repository.hpp>
+#include <oh/processor.hpp>
+#include <oh/scenario.hpp>
 #include <oh/serializationfactory.hpp>
 #include <oh/exception.hpp>
 #include <oh/group.hpp>
+#include <boost/container/small_vector.hpp>
 #include <boost/regex.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/weak_ptr.hpp>
+#include <map>
 #include <ostream>
 #include <sstream>
 
@@ -44,6 +50,24 @@ namespace ObjectHandler {
     // so instead we use a static variable.
     Repository::ObjectMap objectMap_;
 
+    namespace {
+
+        // Reference to an Object downcast to a given type, valid as long
+        // as the ObjectWrapper holds the same version of the Object.
+        struct CachedObject {
+            const std::type_info* type;
+            boost::weak_ptr<ObjectWrapper> objWrapper;
+            unsigned long version;
+            void* typed;
+        };
+
+        // Keyed by formatted ID; few types are requested for each ID.
+        typedef boost::unordered_map<string,
+            boost::container::small_vector<CachedObject, 2> > ObjectCache;
+        ObjectCache objectCache_;
+
+    }
+
     Repository::Repository() {
         instance_ = this;
     }
@@ -63,12 +87,22 @@ namespace ObjectHandler {
                                    const shared_ptr<Object> &object,
                                    bool overwrite,
                                    boost::shared_ptr<ValueObject>) {
+        if (Scenario* scenario = Scenario::current()) {
+            OH_REQUIRE(overwrite ||
+                       !(objectExists(objectID) || scenario->overridden(objectID)),
+                       "Cannot store object with ID '" << objectID <<
+                       "' because an object with that ID already exists");
+            scenario->overrideObject(objectID, object);
+            return objectID;
+        }
+
         OH_REQUIRE(overwrite || !objectExists(objectID),
                    "Cannot store object with ID '" << objectID <<
                    "' because an object with that ID already exists");
 
         if(objectExists(objectID)){
             ObjectMap::const_iterator result = objectMap_.find(objectID);
+            checkCycle(result->second, object);
             //result->second->notifyObservers();
             result->second->reset(object);
         } else{
@@ -87,7 +121,14 @@ namespace ObjectHandler {
 
     shared_ptr<Object> Repository::retrieveObjectImpl(const string &objectID) {
 
-        ObjectMap::const_iterator result = objectMap_.find(formatID(objectID));
+        string realID = formatID(objectID);
+        if (Scenario* scenario = Scenario::current()) {
+            shared_ptr<Object> object = retrieveScenarioObject(*scenario, realID);
+            if (object)
+                return object;
+        }
+
+        ObjectMap::const_iterator result = objectMap_.find(realID);
         OH_REQUIRE(result != objectMap_.end(),
                    "ObjectHandler error: attempt to retrieve object "
                    "with unknown ID '" << objectID << "'");
@@ -97,6 +138,42 @@ namespace ObjectHandler {
         return result->second->object();
     }
 
+    shared_ptr<Object> Repository::retrieveScenarioObject(Scenario &scenario,
+                                                          const string &objectID) {
+        shared_ptr<Object> object;
+        if (scenario.find(objectID, object))
+            return object;
+
+        // The Object is recreated within the Scenario as soon as one of its
+        // precedents, or of the Objects attached to it after construction,
+        // is seen differently there; its creator and its Processor then
+        // retrieve them through the Scenario as well.
+        ObjectMap::const_iterator result = objectMap_.find(objectID);
+        if (result != objectMap_.end()) {
+            shared_ptr<ValueObject> properties = result->second->object()->properties();
+            if (properties) {
+                ProcessorPtr processor =
+                    ProcessorFactory::instance().getProcessor(properties);
+                set<string> precedents = properties->getPrecedentObjects();
+                if (processor) {
+                    set<string> members = processor->memberPrecedents(properties);
+                    precedents.insert(members.begin(), members.end());
+                }
+                for (set<string>::const_iterator i = precedents.begin();
+                     i != precedents.end(); ++i) {
+                    if (retrieveScenarioObject(scenario, formatID(*i))) {
+                        object = SerializationFactory::instance().recreateObject(properties);
+                        if (processor)
+                            processor->restore(properties, object);
+                        break;
+                    }
+                }
+            }
+        }
+        scenario.store(objectID, object);
+        return object;
+    }
+
     const shared_ptr<ObjectWrapper>&
     Repository::getObjectWrapper(const string &objectID) const {
 
@@ -110,15 +187,133 @@ namespace ObjectHandler {
 
     void Repository::registerObserver(shared_ptr<ObjectWrapper> objWrapper) {
 
-        objWrapper->unregisterWithAll();
-
         const set<string>& relationObs =
             objWrapper->object()->properties()->getPrecedentObjects();
+        std::vector<shared_ptr<Observable> > precedents;
+        precedents.reserve(relationObs.size());
         set<string>::const_iterator iter = relationObs.begin();
-        for(; iter != relationObs.end();  iter++) {
-            shared_ptr<ObjectWrapper> objServable =
-                                            getObjectWrapper(formatID(*iter));
-            objWrapper->registerWith(objServable);
+        for(; iter != relationObs.end();  iter++)
+            precedents.push_back(getObjectWrapper(formatID(*iter)));
+
+        // only the links to precedents which changed are touched
+        objWrapper->registerWithOnly(precedents);
+    }
+
+    namespace {
+
+        string wrapperID(const Observable* observable) {
+            const ObjectWrapper* objWrapper =
+                dynamic_cast<const ObjectWrapper*>(observable);
+            shared_ptr<Object> object;
+            if (objWrapper)
+                object = objWrapper->object();
+            return object && object->properties() ?
+                object->properties()->objectId() : string("<unknown>");
+        }
+
+    }
+
+    void* Repository::retrieveCachedObject(const string &objectID,
+                                           const std::type_info &type,
+                                           shared_ptr<Object> &object) {
+        if (objectCache_.empty() || Scenario::current())
+            return 0;
+        ObjectCache::const_iterator entries = objectCache_.find(formatID(objectID));
+        if (entries == objectCache_.end())
+            return 0;
+        for (std::size_t i = 0; i < entries->second.size(); ++i) {
+            const CachedObject& entry = entries->second[i];
+            if (*entry.type == type) {
+                shared_ptr<ObjectWrapper> objWrapper = entry.objWrapper.lock();
+                // a dirty Object must be recreated by retrieveObjectImpl
+                if (!objWrapper || objWrapper->dirty() ||
+                    objWrapper->version() != entry.version)
+                    return 0;
+                object = objWrapper->object();
+                return entry.typed;
+            }
+        }
+        return 0;
+    }
+
+    void Repository::cacheObject(const string &objectID,
+                                 const std::type_info &type,
+                                 const shared_ptr<Object> &object,
+                                 void* typed) {
+        if (Scenario::current())
+            return;
+        string realID = formatID(objectID);
+        ObjectMap::const_iterator result = objectMap_.find(realID);
+        if (result == objectMap_.end() || result->second->object() != object)
+            return;
+
+        CachedObject entry;
+        entry.type = &type;
+        entry.objWrapper = result->second;
+        entry.version = result->second->version();
+        entry.typed = typed;
+
+        ObjectCache::mapped_type& entries = objectCache_[realID];
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (*entries[i].type == type) {
+                entries[i] = entry;
+                return;
+            }
+        }
+        entries.push_back(entry);
+    }
+
+    void Repository::clearCache() {
+        objectCache_.clear();
+    }
+
+    void Repository::checkCycle(const shared_ptr<ObjectWrapper> &objWrapper,
+                                const shared_ptr<Object> &object) {
+
+        shared_ptr<ValueObject> properties = object->properties();
+        if (!properties)
+            return;
+
+        // Depth-first search of the precedents of the new Object; each
+        // visited precedent is mapped to the Object depending on it, so
+        // that the cycle can be reported.
+        typedef std::map<const Observable*, const Observable*> Dependents;
+        Dependents dependents;
+        std::vector<const Observable*> stack;
+        const set<string>& relationObs = properties->getPrecedentObjects();
+        for (set<string>::const_iterator i = relationObs.begin();
+             i != relationObs.end(); ++i) {
+            ObjectMap::const_iterator result = objectMap_.find(formatID(*i));
+            if (result != objectMap_.end() &&
+                dependents.insert(std::make_pair(result->second.get(),
+                                  static_cast<const Observable*>(0))).second)
+                stack.push_back(result->second.get());
+        }
+
+        while (!stack.empty()) {
+            const Observable* precedent = stack.back();
+            stack.pop_back();
+
+            if (precedent == objWrapper.get()) {
+                std::vector<string> cycle;
+                for (const Observable* o = precedent; o; o = dependents[o])
+                    cycle.push_back(wrapperID(o));
+                std::ostringstream path;
+                path << wrapperID(objWrapper.get());
+                for (std::vector<string>::reverse_iterator i = cycle.rbegin();
+                     i != cycle.rend(); ++i)
+                    path << " -> " << *i;
+                OH_FAIL("Cannot store object with ID '" << properties->objectId() <<
+                        "' because it would depend on itself: " << path.str());
+            }
+
+            if (const Observer* observer = dynamic_cast<const Observer*>(precedent)) {
+                for (std::size_t i = 0; i < observer->observableCount(); ++i) {
+                    const Observable* next = observer->observable(i).get();
+                    if (dependents.insert(std::make_pair(next, precedent)).second)
+                        stack.push_back(next);
+                }
+            }
         }
     }
 
@@ -128,6 +323,7 @@ namespace ObjectHandler {
                    "Cannot delete '" << realID << "' because no Object with "
                    "that ID is present in the Repository");
         objectMap_.erase(realID);
+        clearCache();
     }
 
     void Repository::deleteObject(const std::vector<string> &objectIDs) {
@@ -140,6 +336,7 @@ namespace ObjectHandler {
 
     void Repository::deleteAllObjects(const bool &deletePermanent) {
 
+        clearCache();
         if (deletePermanent) {
             objectMap_.clear();
         } else {
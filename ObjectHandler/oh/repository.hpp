@@ -29,6 +29,7 @@
 #include <oh/ohdefines.hpp>
 #include <oh/iless.hpp>
 #include <map>
+#include <typeinfo>
 
 //! ObjectHandler
 /*! Namespace for ObjectHandler functionality.
@@ -37,6 +38,7 @@ namespace ObjectHandler {
 
 	//! Forward declarations
 	class Group;
+	class Scenario;
 
     //! Maintain a store of Objects.
     /*! The client application may store, retrieve, and delete Objects in
@@ -84,16 +86,26 @@ namespace ObjectHandler {
             Throw an exception if no Object exists with that ID.
             This template passes the work off to function retrieveObjectImpl which
             may be overridden in derived classes.
+
+            The downcast reference is cached for the ID and type requested, so
+            that retrieving the same Object again skips both the lookup and the
+            downcast until the Object is replaced, recreated or deleted.
         */
         template <class T>
         void retrieveObject(boost::shared_ptr<T> &ret,
                             const std::string &id) {
-            boost::shared_ptr<Object> object = retrieveObjectImpl(id);
+            boost::shared_ptr<Object> object;
+            if (void* cached = retrieveCachedObject(id, typeid(T), object)) {
+                ret = boost::shared_ptr<T>(object, static_cast<T*>(cached));
+                return;
+            }
+            object = retrieveObjectImpl(id);
             ret = boost::dynamic_pointer_cast<T>(object);
             OH_REQUIRE(ret, "Error retrieving object with id '"
                 << id << "' - unable to convert reference to type '"
                 << typeid(T).name() << "' found instead '"
                 << typeid(*object).name() << "'");
+            cacheObject(id, typeid(T), object, ret.get());
         }
 
         //! Override of template function retrieveObject.
@@ -192,10 +204,20 @@ namespace ObjectHandler {
         /*! The given ObjectWrapper is registered as an Observer of all of its
             precedent ObjectWrappers, which in this case act as Observables.
             If any of the precedents changes, then the Observer is notified.
+            When an Object is overwritten, the links to the precedents it
+            shares with the Object it replaces are kept.
         */
         virtual void registerObserver( 
             boost::shared_ptr<ObjectWrapper> objWrapper);
 
+        //! Check that an Object can replace the one in the given ObjectWrapper.
+        /*! Throws if the replaced Object is among the precedents, direct or
+            indirect, of the replacing one, which would close a cycle.  Only
+            the precedents of the replacing Object are visited.
+        */
+        void checkCycle(const boost::shared_ptr<ObjectWrapper>& objWrapper,
+                        const boost::shared_ptr<Object>& object);
+
         //! Convert Excel-format Object IDs into the format recognized by the base Repository class
         /*! The functiong will be used in derived class(e.g in class
             repositoryXL it will change the objectID custom_#0001 into custom);
@@ -208,6 +230,35 @@ namespace ObjectHandler {
         //! Retrieve the list of IDs of precedent objects containde in this group
 		virtual const std::vector<std::string> precedentIDs(const boost::shared_ptr<Group>& group);
 
+        //! \name Typed retrieval cache
+        //@{
+        //! Reference to the Object with the given ID cached for the given type.
+        /*! Returns the reference downcast to the given type and sets object,
+            or returns null if nothing valid is cached.  Nothing is cached
+            for threads bound to a Scenario.
+        */
+        virtual void* retrieveCachedObject(const std::string &objectID,
+                                           const std::type_info &type,
+                                           boost::shared_ptr<Object> &object);
+        //! Cache the reference to the given Object downcast to the given type.
+        /*! Nothing is cached unless the Object is the one stored under the
+            given ID.
+        */
+        virtual void cacheObject(const std::string &objectID,
+                                 const std::type_info &type,
+                                 const boost::shared_ptr<Object> &object,
+                                 void* typed);
+        //! Discard the cached references, e.g. when Objects are deleted.
+        void clearCache();
+        //@}
+
+        //! Retrieve the Object with the given ID as seen in the given Scenario.
+        /*! Returns a null pointer if the Scenario shares the Object stored
+            in the Repository.
+        */
+        boost::shared_ptr<Object> retrieveScenarioObject(Scenario& scenario,
+                                                         const std::string& objectID);
+
     };
 
 }
@@ -0,0 +1,83 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+#include <oh/config.hpp>
+#endif
+
+#include <oh/scenario.hpp>
+#include <boost/thread/tss.hpp>
+
+namespace ObjectHandler {
+
+    namespace {
+
+        // The bound Scenario is not owned by the thread, hence the no-op cleanup.
+        void unbind(Scenario*) {}
+
+        boost::thread_specific_ptr<Scenario>& boundScenario() {
+            static boost::thread_specific_ptr<Scenario> scenario(unbind);
+            return scenario;
+        }
+
+    }
+
+    void Scenario::overrideObject(const std::string& objectID,
+                                  const boost::shared_ptr<Object>& object) {
+        overrides_[objectID] = object;
+        objects_.clear();
+    }
+
+    bool Scenario::overridden(const std::string& objectID) const {
+        return overrides_.find(objectID) != overrides_.end();
+    }
+
+    std::size_t Scenario::recreatedCount() const {
+        std::size_t count = 0;
+        for (ObjectMap::const_iterator i = objects_.begin(); i != objects_.end(); ++i) {
+            if (i->second)
+                ++count;
+        }
+        return count;
+    }
+
+    Scenario* Scenario::current() {
+        return boundScenario().get();
+    }
+
+    void Scenario::bind(Scenario* scenario) {
+        boundScenario().reset(scenario);
+    }
+
+    bool Scenario::find(const std::string& objectID,
+                        boost::shared_ptr<Object>& object) const {
+        ObjectMap::const_iterator i = overrides_.find(objectID);
+        if (i == overrides_.end()) {
+            i = objects_.find(objectID);
+            if (i == objects_.end())
+                return false;
+        }
+        object = i->second;
+        return true;
+    }
+
+    void Scenario::store(const std::string& objectID,
+                         const boost::shared_ptr<Object>& object) {
+        objects_[objectID] = object;
+    }
+
+}
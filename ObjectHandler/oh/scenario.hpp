@@ -0,0 +1,107 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Class Scenario - Overlay of Objects on top of the Repository
+*/
+
+#ifndef oh_scenario_hpp
+#define oh_scenario_hpp
+
+#include <oh/object.hpp>
+#include <oh/iless.hpp>
+#include <boost/shared_ptr.hpp>
+#include <map>
+#include <string>
+
+namespace ObjectHandler {
+
+    //! Copy-on-write overlay of Objects on top of the Repository.
+    /*! While a thread is bound to a Scenario, the Repository resolves the
+        IDs it is asked for against the Scenario first.  Objects stored by
+        the thread, or passed to overrideObject(), replace the Objects with
+        the same IDs for that thread only.  Objects depending, directly or
+        through their precedents, on a replaced Object are recreated from
+        their ValueObjects the first time they are retrieved, and kept in
+        the Scenario; all other Objects are shared with the Repository.
+        Objects attached by member functions after construction, such as
+        pricing engines, count as precedents too: the Processor of each
+        recreated Object names them and attaches them again.
+
+        Discarding the Scenario discards everything it holds and leaves
+        the Repository untouched, so any number of Scenarios can be
+        evaluated against one base market, one after the other.
+
+        Scenarios are evaluated one at a time; they do not run in parallel.
+        Only one thread at a time may be bound to any Scenario, and no
+        other thread may use the Repository meanwhile.  The Objects
+        recreated within a Scenario register with the library observables
+        of the Objects they share with the Repository, and the
+        registration lists of those observables are not protected against
+        concurrent changes.
+    */
+    class Scenario {
+    public:
+        //! Replace the Object with the given ID within this Scenario.
+        /*! The ID is the one under which the Repository stores the Object.
+            Objects already recreated within this Scenario are discarded.
+        */
+        void overrideObject(const std::string& objectID,
+                            const boost::shared_ptr<Object>& object);
+        //! Determine whether the Object with the given ID was replaced.
+        bool overridden(const std::string& objectID) const;
+        //! Number of Objects recreated within this Scenario.
+        std::size_t recreatedCount() const;
+
+        //! The Scenario to which the calling thread is bound, if any.
+        static Scenario* current();
+
+    private:
+        friend class Repository;
+        friend class ScenarioBinding;
+        static void bind(Scenario* scenario);
+        // Object with the given ID as seen in this Scenario; returns false
+        // if the ID was never resolved, null if the Object is shared.
+        bool find(const std::string& objectID,
+                  boost::shared_ptr<Object>& object) const;
+        void store(const std::string& objectID,
+                   const boost::shared_ptr<Object>& object);
+
+        typedef std::map<std::string, boost::shared_ptr<Object>, my_iless> ObjectMap;
+        ObjectMap overrides_;
+        ObjectMap objects_;
+    };
+
+    //! Bind the calling thread to a Scenario for the lifetime of this object.
+    class ScenarioBinding {
+    public:
+        explicit ScenarioBinding(Scenario& scenario)
+            : previous_(Scenario::current()) {
+            Scenario::bind(&scenario);
+        }
+        ~ScenarioBinding() {
+            Scenario::bind(previous_);
+        }
+    private:
+        ScenarioBinding(const ScenarioBinding&);
+        ScenarioBinding& operator=(const ScenarioBinding&);
+        Scenario* previous_;
+    };
+
+}
+
+#endif
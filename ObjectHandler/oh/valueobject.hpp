@@ -31,12 +31,25 @@
 #include <map>
 #include <set>
 #include <algorithm>
+#include <cctype>
 #include <oh/property.hpp>
 #include <oh/utilities.hpp>
 #include <boost/serialization/access.hpp>
 
 namespace ObjectHandler {
 
+    //! Compare a name, regardless of case, with an upper case name of the same length.
+    /*! Used by the property lookups generated by gensrc, which switch on the
+        length of the name before calling this function.
+    */
+    inline bool equalsUpper(const std::string& name, const char* upper) {
+        for (std::string::size_type i = 0; i < name.size(); ++i) {
+            if (std::toupper(static_cast<unsigned char>(name[i])) != upper[i])
+                return false;
+        }
+        return true;
+    }
+
     //! Capture the values of the arguments passed to the Object constructor.
     /*! For each class derived from Object there is a corresponding ValueObject
         class.  The source code of classes derived from ValueObject is generated
@@ -88,6 +101,14 @@ namespace ObjectHandler {
         property_t getProperty(const std::string& name) const;
         //! Retrieve the value of a system property given its name.
         virtual property_t getSystemProperty(const std::string& name) const = 0;
+        //! Retrieve the value of a system property given its index.
+        /*! Indices run over the system properties in the order of
+            getPropertyNamesVector(), then ObjectId and ClassName, so that
+            bulk callers such as the serialization creators avoid looking up
+            each name.  Generated classes switch directly on the index; this
+            default looks up the name.
+        */
+        virtual property_t getSystemProperty(std::size_t index) const;
         //! Determine whether the given user property is present.
         bool hasProperty(const std::string& name) const;
         //! Set the value of the given property.
@@ -181,12 +202,24 @@ namespace ObjectHandler {
     }
 
     inline property_t ValueObject::getProperty(const std::string& name) const {
-        if(userProperties.find(name) != userProperties.end())
-            return userProperties.find(name)->second;
+        std::map<std::string, property_t>::const_iterator i = userProperties.find(name);
+        if(i != userProperties.end())
+            return i->second;
         else
             return getSystemProperty(name);
     }
 
+    inline property_t ValueObject::getSystemProperty(std::size_t index) const {
+        std::size_t count = getSystemPropertyNames().size();
+        if (index < count)
+            return getSystemProperty(getPropertyNamesVector()[index]);
+        else if (index == count)
+            return objectId_;
+        else if (index == count + 1)
+            return className_;
+        OH_FAIL("Error: attempt to retrieve non-existent Property: index " << index);
+    }
+
     inline bool ValueObject::hasProperty(const std::string& name) const {
         return userProperties.find(name) != userProperties.end();
     }
@@ -69,6 +69,7 @@ namespace ObjectHandler {
     }
 
     void RepositoryXL::clear() {
+        clearCache();
         objectMap_.clear();
         errorMessageMap_.clear();
         callingRanges_.clear();
@@ -94,6 +95,7 @@ namespace ObjectHandler {
                 callingRange->registerObject(objectID, objectWrapperXL);
             } else {
                 objectWrapperXL = boost::static_pointer_cast<ObjectWrapperXL>(result->second);
+                checkCycle(objectWrapperXL, object);
                 if (objectWrapperXL->callerKey() != callingRange->key()) {
                     OH_REQUIRE(overwrite, "Cannot create object with ID '" << objectID <<
                         "' in cell " << callingRange->addressString() <<
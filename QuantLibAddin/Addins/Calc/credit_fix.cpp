@@ -323,6 +323,7 @@ STRING SAL_CALL CalcAddins_impl::qlMidPointCdsEngine(
                 DefaultCurveCpp,
                 RecoveryRate,
                 YieldCurveCpp,
+                false,
                 PermanentCpp));
 
         // Construct the Object
@@ -333,6 +334,7 @@ STRING SAL_CALL CalcAddins_impl::qlMidPointCdsEngine(
                 DefaultCurveLibObj,
                 RecoveryRateLib,
                 YieldCurveLibObj,
+                false,
                 PermanentCpp));
 
         // Store the Object in the Repository
@@ -22,11 +22,13 @@
 #include <oh/enumerations/enumregistry.hpp>
 #include <qlo/enumerations/register/register_all.hpp>
 #include <qlo/serialization/serializationfactory.hpp>
+#include <qlo/sessions.hpp>
 
 void QuantLibAddinCpp::initializeAddin() {
 
-        // Instantiate the ObjectHandler Repository
-        static ObjectHandler::Repository repository;
+        // Instantiate the ObjectHandler Repository, qualifying object IDs
+        // with the namespace of the session of the calling thread
+        static QuantLibAddin::SessionRepository repository;
 
         //Instantiate the Processor Factory
         static ObjectHandler::ProcessorFactory processorFactory;
@@ -48,3 +50,11 @@ void QuantLibAddinCpp::initializeAddin() {
 
 }
 
+#ifdef QL_ENABLE_SESSIONS
+
+// worker threads select their session through QuantLibAddin::Sessions
+QuantLib::Integer QuantLib::sessionId() {
+    return QuantLibAddin::Sessions::instance().current();
+}
+
+#endif
@@ -697,48 +697,37 @@ codeCalc218 = '''\
 ##########################################################################
 
 code66 = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
             return %(name)s_;\n'''
 
 code66a = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
             return %(name)s_;\n'''
 
 code67a = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
             %(name)s_ = value;\n'''
 
 code67b = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
             %(name)s_ = ObjectHandler::convert2<std::string>(value);\n'''
 
 code67c = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
             %(name)s_ = ObjectHandler::convert2<%(nativeType)s>(value);\n'''
 
 code67d = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::vector::convert2<ObjectHandler::property_t>(value, nameUpper);\n'''
+            %(name)s_ = ObjectHandler::vector::convert2<ObjectHandler::property_t>(value, "%(name)s");\n'''
 
 code67e = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::vector::convert2<std::string>(value, nameUpper);\n'''
+            %(name)s_ = ObjectHandler::vector::convert2<std::string>(value, "%(name)s");\n'''
 
 code67f = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::vector::convert2<%(nativeType)s>(value, nameUpper);\n'''
+            %(name)s_ = ObjectHandler::vector::convert2<%(nativeType)s>(value, "%(name)s");\n'''
 
 code67g = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::matrix::convert2<ObjectHandler::property_t>(value, nameUpper);\n'''
+            %(name)s_ = ObjectHandler::matrix::convert2<ObjectHandler::property_t>(value, "%(name)s");\n'''
 
 code67h = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::matrix::convert2<std::string>(value, nameUpper);\n'''
+            %(name)s_ = ObjectHandler::matrix::convert2<std::string>(value, "%(name)s");\n'''
 
 code67i = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::matrix::convert2<%(nativeType)s>(value, nameUpper);\n'''
+            %(name)s_ = ObjectHandler::matrix::convert2<%(nativeType)s>(value, "%(name)s");\n'''
 
 code68 = '''\
             processVariant(%(name)s);'''
@@ -769,53 +758,53 @@ code70b = '''\
 
 code110 = '''\
         ObjectHandler::property_t %(name)s =
-            valueObject->getProperty("%(name)s");\n'''
+            valueObject->getSystemProperty(%(propertyIndex)s);\n'''
 
 code111 = '''\
         std::string %(name)s =
-            ObjectHandler::convert2<std::string>(valueObject->getProperty("%(name)s"));\n'''
+            ObjectHandler::convert2<std::string>(valueObject->getSystemProperty(%(propertyIndex)s));\n'''
 
 code112 = '''\
         %(nativeType)s %(name)s =
-            ObjectHandler::convert2<%(nativeType)s>(valueObject->getProperty("%(name)s"));\n'''
+            ObjectHandler::convert2<%(nativeType)s>(valueObject->getSystemProperty(%(propertyIndex)s));\n'''
 
 code113 = '''\
         std::vector<%(nativeType)s> %(name)s =
-            ObjectHandler::vector::convert2<%(nativeType)s>(valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+            ObjectHandler::vector::convert2<%(nativeType)s>(valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 
 #code114 = '''\
 #        std::vector<ObjectHandler::property_t> %(name)s =
-#            ObjectHandler::convert2<std::vector<ObjectHandler::property_t> >(valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+#            ObjectHandler::convert2<std::vector<ObjectHandler::property_t> >(valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 code114 = '''\
         std::vector<ObjectHandler::property_t> %(name)s =
-            ObjectHandler::vector::convert2<ObjectHandler::property_t>(valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+            ObjectHandler::vector::convert2<ObjectHandler::property_t>(valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 
 code115 = '''\
         std::vector<std::string> %(name)s =
-            ObjectHandler::vector::convert2<std::string>(valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+            ObjectHandler::vector::convert2<std::string>(valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 
 code116 = '''\
         std::vector<std::vector<std::string> > %(name)s =
-            ObjectHandler::matrix::convert2<std::string>(valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+            ObjectHandler::matrix::convert2<std::string>(valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 
 code117 = '''\
         std::vector<std::vector<%(nativeType)s> > %(name)s =
-            ObjectHandler::matrix::convert2<%(nativeType)s>(valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+            ObjectHandler::matrix::convert2<%(nativeType)s>(valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 
 code118 = '''\
         std::vector<std::vector<ObjectHandler::property_t> > %(name)s =
-            ObjectHandler::matrix::convert2<ObjectHandler::property_t>(valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+            ObjectHandler::matrix::convert2<ObjectHandler::property_t>(valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 
 code121a = '''\
         %(type)s %(nameConverted)s = %(name)s;\n'''
 
 code121 = '''\
         %(type)s %(nameConverted)s = ObjectHandler::convert2<%(type)s>(
-            valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+            valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 
 code122 = '''\
         %(type)s %(nameConverted)s = ObjectHandler::convert2<%(type)s>(
-            valueObject->getProperty("%(name)s"), "%(name)s", %(defaultValue)s);\n'''
+            valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s", %(defaultValue)s);\n'''
 
 code123 = '''\
         std::string %(name)sCpp = ObjectHandler::convert2<std::string>(
@@ -19,7 +19,19 @@
 
 #include <qlo/baseinstruments.hpp>
 #include <qlo/pricingengines.hpp>
+#include <qlo/parallel.hpp>
+#include <oh/repository.hpp>
+#include <oh/conversions/convert2.hpp>
 #include <ql/instrument.hpp>
+#include <ql/cashflows/couponpricer.hpp>
+#include <ql/cashflows/floatingratecoupon.hpp>
+#include <ql/indexes/swapindex.hpp>
+#include <ql/instruments/bond.hpp>
+#include <ql/instruments/swap.hpp>
+#include <ql/utilities/null.hpp>
+#include <algorithm>
+#include <set>
+#include <sstream>
 
 namespace QuantLibAddin {
 
@@ -35,4 +47,213 @@ namespace QuantLibAddin {
         std::string engineId = eng_properties->objectId();
         inst_properties->setProperty("EngineID", engineId);
     }
+
+    namespace {
+
+        struct Valuation {
+            Valuation() : npv(QuantLib::Null<QuantLib::Real>()) {}
+            QuantLib::Real npv;
+            std::vector<QuantLib::Real> results;
+            std::string error;
+        };
+
+        // Coupon pricers are set on the coupons by qlLegSetCouponPricers and
+        // are not precedents of the instruments: pricers shared between
+        // instruments are found through the coupons and key the groups, as
+        // they store the coupon being priced.  The volatilities they hold
+        // are calculated and the fixing histories of the coupon indexes,
+        // which the IndexManager adds on first access, retrieved here.
+        void prepareCoupons(const QuantLib::Leg& leg,
+                            std::vector<std::string>& keys,
+                            std::set<const void*>& prepared) {
+            for (QuantLib::Size i=0; i<leg.size(); ++i) {
+                boost::shared_ptr<QuantLib::FloatingRateCoupon> coupon =
+                    boost::dynamic_pointer_cast<QuantLib::FloatingRateCoupon>(leg[i]);
+                if (!coupon)
+                    continue;
+                boost::shared_ptr<QuantLib::FloatingRateCouponPricer> pricer =
+                    coupon->pricer();
+                if (pricer) {
+                    std::ostringstream key;
+                    key << "pricer " << pricer.get();
+                    keys.push_back(key.str());
+                    if (prepared.insert(pricer.get()).second) {
+                        if (boost::shared_ptr<QuantLib::IborCouponPricer> ibor =
+                                boost::dynamic_pointer_cast<QuantLib::IborCouponPricer>(pricer)) {
+                            if (!ibor->capletVolatility().empty())
+                                calculateLazyObject(ibor->capletVolatility().currentLink());
+                        } else if (boost::shared_ptr<QuantLib::CmsCouponPricer> cms =
+                                boost::dynamic_pointer_cast<QuantLib::CmsCouponPricer>(pricer)) {
+                            if (!cms->swaptionVolatility().empty())
+                                calculateLazyObject(cms->swaptionVolatility().currentLink());
+                        }
+                    }
+                }
+                boost::shared_ptr<QuantLib::InterestRateIndex> index = coupon->index();
+                if (index && prepared.insert(index.get()).second) {
+                    index->timeSeries();
+                    if (boost::shared_ptr<QuantLib::SwapIndex> swapIndex =
+                            boost::dynamic_pointer_cast<QuantLib::SwapIndex>(index))
+                        swapIndex->iborIndex()->timeSeries();
+                }
+            }
+        }
+
+        void prepareCoupons(const QuantLib::Instrument& instrument,
+                            std::vector<std::string>& keys,
+                            std::set<const void*>& prepared) {
+            if (const QuantLib::Swap* swap =
+                    dynamic_cast<const QuantLib::Swap*>(&instrument)) {
+                for (QuantLib::Size j=0; j<swap->legs().size(); ++j)
+                    prepareCoupons(swap->legs()[j], keys, prepared);
+            } else if (const QuantLib::Bond* bond =
+                    dynamic_cast<const QuantLib::Bond*>(&instrument)) {
+                prepareCoupons(bond->cashflows(), keys, prepared);
+            }
+        }
+
+        // Prices the instruments of one group, i.e. sharing an engine whose
+        // arguments and results can't be used by two instruments at once,
+        // or a coupon pricer.
+        class EngineGroupValuation {
+          public:
+            EngineGroupValuation(
+                const std::vector<boost::shared_ptr<QuantLib::Instrument> >& instruments,
+                const std::vector<std::string>& resultTypes,
+                const std::vector<std::vector<QuantLib::Size> >& groups,
+                QuantLib::Size begin,
+                QuantLib::Size end,
+                std::vector<Valuation>& valuations)
+            : instruments_(instruments), resultTypes_(resultTypes),
+              groups_(groups), begin_(begin), end_(end), valuations_(valuations) {}
+            void operator()(QuantLib::Size g) {
+                QuantLib::Size end = std::min(end_, groups_[g].size());
+                for (QuantLib::Size k=begin_; k<end; ++k) {
+                    QuantLib::Size i = groups_[g][k];
+                    Valuation& valuation = valuations_[i];
+                    try {
+                        valuation.npv = instruments_[i]->NPV();
+                    } catch (std::exception& e) {
+                        valuation.error = e.what();
+                        continue;
+                    }
+                    valuation.results.resize(resultTypes_.size(),
+                                             QuantLib::Null<QuantLib::Real>());
+                    for (QuantLib::Size j=0; j<resultTypes_.size(); ++j) {
+                        // results not provided by the engine are left empty
+                        try {
+                            valuation.results[j] =
+                                instruments_[i]->result<QuantLib::Real>(resultTypes_[j]);
+                        } catch (std::exception&) {}
+                    }
+                }
+            }
+          private:
+            const std::vector<boost::shared_ptr<QuantLib::Instrument> >& instruments_;
+            const std::vector<std::string>& resultTypes_;
+            const std::vector<std::vector<QuantLib::Size> >& groups_;
+            QuantLib::Size begin_, end_;
+            std::vector<Valuation>& valuations_;
+        };
+
+    }
+
+    std::vector<std::vector<ObjectHandler::property_t> > instrumentNPVBatch(
+        const std::vector<std::string>& instrumentIds,
+        const std::vector<std::string>& resultTypes,
+        QuantLib::Size threads) {
+
+        QL_REQUIRE(!instrumentIds.empty(), "no instruments given");
+
+        // the repository is only accessed from the calling thread
+        QuantLib::Size n = instrumentIds.size();
+        std::vector<boost::shared_ptr<QuantLib::Instrument> > instruments(n);
+        std::vector<Valuation> valuations(n);
+        std::vector<std::vector<std::string> > keys(n);
+        std::set<const ObjectHandler::Object*> reached;
+        std::set<const void*> prepared;
+        for (QuantLib::Size i=0; i<n; ++i) {
+            std::string engineId;
+            try {
+                boost::shared_ptr<ObjectHandler::LibraryObject<QuantLib::Instrument> > object;
+                ObjectHandler::Repository::instance().retrieveObject(object, instrumentIds[i]);
+                object->getLibraryObject(instruments[i]);
+                // the engine is recorded by setPricingEngine; instruments
+                // without one have no engine shared with the others
+                boost::shared_ptr<ObjectHandler::ValueObject> properties =
+                    object->properties();
+                if (properties->hasProperty("EngineID")) {
+                    engineId = ObjectHandler::convert2<std::string>(
+                        properties->getProperty("EngineID"), "EngineID");
+                    keys[i].push_back(engineId);
+                }
+                prepareCoupons(*instruments[i], keys[i], prepared);
+            } catch (std::exception& e) {
+                instruments[i].reset();
+                keys[i].clear();
+                valuations[i].error = e.what();
+                continue;
+            }
+            collectPrecedents(instrumentIds[i], reached);
+            if (!engineId.empty())
+                collectPrecedents(engineId, reached);
+        }
+        std::vector<std::vector<QuantLib::Size> > groups;
+        std::vector<std::vector<QuantLib::Size> > keyGroups =
+            groupBySharedKeys(keys);
+        for (QuantLib::Size g=0; g<keyGroups.size(); ++g) {
+            if (instruments[keyGroups[g][0]])
+                groups.push_back(keyGroups[g]);
+        }
+
+        // Distinct engines may share lazy objects, e.g. a discount curve
+        // or a volatility cube: every term structure and quote reached by
+        // the batch is calculated here, so that the worker threads only
+        // read them.
+        for (std::set<const ObjectHandler::Object*>::const_iterator
+                 i=reached.begin(); i!=reached.end(); ++i)
+            calculateLazyObject(*i);
+
+        // The first instrument of each group is priced on the calling
+        // thread, which calculates any other lazy object its engine
+        // depends on; the other instruments then price concurrently.
+        EngineGroupValuation heads(instruments, resultTypes, groups,
+                                   0, 1, valuations);
+        parallelFor(groups.size(), 1, heads);
+        EngineGroupValuation tails(instruments, resultTypes, groups,
+                                   1, n, valuations);
+        parallelFor(groups.size(), threads, tails);
+
+        std::vector<std::vector<ObjectHandler::property_t> > result;
+        std::vector<ObjectHandler::property_t> headings;
+        headings.reserve(resultTypes.size() + 3);
+        headings.push_back(std::string("Instrument"));
+        headings.push_back(std::string("NPV"));
+        for (QuantLib::Size j=0; j<resultTypes.size(); ++j)
+            headings.push_back(resultTypes[j]);
+        headings.push_back(std::string("Error"));
+        result.push_back(headings);
+
+        for (QuantLib::Size i=0; i<n; ++i) {
+            const Valuation& valuation = valuations[i];
+            std::vector<ObjectHandler::property_t> row;
+            row.reserve(headings.size());
+            row.push_back(instrumentIds[i]);
+            if (valuation.npv != QuantLib::Null<QuantLib::Real>())
+                row.push_back(valuation.npv);
+            else
+                row.push_back(std::string("#N/A"));
+            for (QuantLib::Size j=0; j<resultTypes.size(); ++j) {
+                if (j < valuation.results.size() &&
+                    valuation.results[j] != QuantLib::Null<QuantLib::Real>())
+                    row.push_back(valuation.results[j]);
+                else
+                    row.push_back(std::string("#N/A"));
+            }
+            row.push_back(valuation.error);
+            result.push_back(row);
+        }
+        return result;
+    }
+
 }
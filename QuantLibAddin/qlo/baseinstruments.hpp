@@ -21,6 +21,10 @@
 #define qla_baseinstruments_hpp
 
 #include <oh/libraryobject.hpp>
+#include <oh/property.hpp>
+#include <ql/types.hpp>
+#include <string>
+#include <vector>
 
 namespace QuantLib {
     class Instrument;
@@ -40,6 +44,22 @@ namespace QuantLibAddin {
 
     OH_OBJ_CLASS(OneAssetOption, Instrument);
 
+    // Prices the given instruments and returns their NPV and the requested
+    // additional results, one row per instrument.  Instruments sharing a
+    // pricing engine, as recorded in their EngineID property, or a coupon
+    // pricer are priced in turn; the others are priced concurrently by up
+    // to the given number of threads, after the term structures and
+    // quotes they depend on have been calculated and the fixing histories
+    // of their coupons retrieved on the calling thread.  Mutable state
+    // shared otherwise than through an engine or a coupon pricer, e.g. an
+    // instrument-specific object hidden inside an engine, is not detected.
+    // Errors are reported for each instrument without interrupting the
+    // others.
+    std::vector<std::vector<ObjectHandler::property_t> > instrumentNPVBatch(
+        const std::vector<std::string>& instrumentIds,
+        const std::vector<std::string>& resultTypes,
+        QuantLib::Size threads);
+
 }
 
 #endif
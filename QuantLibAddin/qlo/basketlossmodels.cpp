@@ -18,6 +18,8 @@
 */
 
 #include <qlo/basketlossmodels.hpp>
+#include <qlo/conditionallossmodels.hpp>
+#include <qlo/parallelrandomlm.hpp>
 
 #include <ql/experimental/credit/gaussianlhplossmodel.hpp>
 #include <ql/experimental/credit/constantlosslatentmodel.hpp>
@@ -37,11 +39,18 @@ namespace QuantLibAddin {
         const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
         QuantLib::Real correl,
         const std::vector<QuantLib::Real>& recoveryRates,
+        bool batched,
         bool permanent
         )
     : DefaultLossModel(properties, permanent) {
-        libraryObject_ = boost::shared_ptr<QuantLib::GaussianLHPLossModel>(new 
-            QuantLib::GaussianLHPLossModel(correl, recoveryRates));
+        if (batched)
+            libraryObject_ =
+                boost::shared_ptr<BatchedGaussianLHPLossModel>(new
+                    BatchedGaussianLHPLossModel(correl, recoveryRates));
+        else
+            libraryObject_ =
+                boost::shared_ptr<QuantLib::GaussianLHPLossModel>(new 
+                    QuantLib::GaussianLHPLossModel(correl, recoveryRates));
     }
 
     IHGaussPoolLossModel::IHGaussPoolLossModel(
@@ -398,6 +407,77 @@ namespace QuantLibAddin {
                 QuantLib::TRandomLossLM(model, numSims));
     }
 
+    GaussianParallelRandomDefaultLM::GaussianParallelRandomDefaultLM(
+        const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+        const std::vector<std::vector<QuantLib::Real> >& factorWeights,
+        const std::vector<QuantLib::Real>& recoveryRates,
+        const QuantLib::Size numSims,
+        const long seed,
+        const QuantLib::Size threads,
+        bool permanent
+        )
+    : DefaultLossModel(properties, permanent) {
+
+        std::vector<std::vector<QuantLib::Real> > usedFactors;
+        //This allow to have just one number without having an extra constructor
+        if(factorWeights.size() == 1 && factorWeights[0].size()== 1 && 
+            recoveryRates.size() > 1) {
+                for(QuantLib::Size i=0; i<recoveryRates.size(); i++)
+                    usedFactors.push_back(std::vector<QuantLib::Real>(1, 
+                       factorWeights[0][0]));
+        }else{
+            usedFactors = factorWeights;
+        }
+        QL_REQUIRE(seed >= 0, "invalid seed: " << seed);
+
+        boost::shared_ptr<QuantLib::GaussianConstantLossLM> model(new 
+            QuantLib::GaussianConstantLossLM(usedFactors, recoveryRates, 
+                QuantLib::LatentModelIntegrationType::GaussianQuadrature));
+
+        libraryObject_ = boost::shared_ptr<QuantLib::DefaultLossModel>(new 
+            ParallelRandomDefaultLM<QuantLib::GaussianCopulaPolicy>(model,
+                recoveryRates, numSims, seed, threads));
+    }
+
+    TParallelRandomDefaultLM::TParallelRandomDefaultLM(
+        const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+        const std::vector<std::vector<QuantLib::Real> >& factorWeights,
+        const std::vector<QuantLib::Real>& recoveryRates,
+        const std::vector<QuantLib::Real>& copulaInitVals,
+        const QuantLib::Size numSims,
+        const long seed,
+        const QuantLib::Size threads,
+        bool permanent
+        )
+    : DefaultLossModel(properties, permanent) {
+
+        std::vector<std::vector<QuantLib::Real> > usedFactors;
+        //This allow to have just one number without having an extra constructor
+        if(factorWeights.size() == 1 && factorWeights[0].size()== 1 && 
+            recoveryRates.size() > 1) {
+                for(QuantLib::Size i=0; i<recoveryRates.size(); i++)
+                    usedFactors.push_back(std::vector<QuantLib::Real>(1, 
+                       factorWeights[0][0]));
+        }else{
+            usedFactors = factorWeights;
+        }
+        QL_REQUIRE(seed >= 0, "invalid seed: " << seed);
+
+        QuantLib::TCopulaPolicy::initTraits  initTT;
+        for(QuantLib::Size i=0; i< copulaInitVals.size(); i++) 
+            initTT.tOrders.push_back(static_cast<QuantLib::Integer>(
+                copulaInitVals[i]));
+
+        boost::shared_ptr<QuantLib::TConstantLossLM> model(new 
+            QuantLib::TConstantLossLM(usedFactors, recoveryRates, 
+                QuantLib::LatentModelIntegrationType::Trapezoid,
+                initTT));
+
+        libraryObject_ = boost::shared_ptr<QuantLib::DefaultLossModel>(new 
+            ParallelRandomDefaultLM<QuantLib::TCopulaPolicy>(model,
+                recoveryRates, numSims, seed, threads));
+    }
+
     SaddlePointLossModel::SaddlePointLossModel(
         const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
         const std::vector<std::vector<QuantLib::Real> >& factorWeights,
@@ -475,6 +555,7 @@ namespace QuantLibAddin {
         const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
         const std::vector<std::vector<QuantLib::Real> >& factorWeights,
         const std::vector<QuantLib::Real>& recoveryRates,
+        bool batched,
         bool permanent
         )
     : DefaultLossModel(properties, permanent) {
@@ -490,6 +571,13 @@ namespace QuantLibAddin {
             usedFactors = factorWeights;
         }
 
+        if (batched) {
+            libraryObject_ =
+                boost::shared_ptr<BatchedRecursiveGaussLossModel>(new
+                    BatchedRecursiveGaussLossModel(usedFactors, recoveryRates));
+            return;
+        }
+
         boost::shared_ptr<QuantLib::GaussianConstantLossLM> model(new 
             QuantLib::GaussianConstantLossLM(usedFactors, recoveryRates, 
                 QuantLib::LatentModelIntegrationType::GaussianQuadrature));
@@ -44,6 +44,7 @@ namespace QuantLibAddin {
             const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
             QuantLib::Real correl,
             const std::vector<QuantLib::Real>& recoveryRates,
+            bool batched,
             bool permanent
             );
     };
@@ -160,6 +161,33 @@ namespace QuantLibAddin {
             );
     };
 
+    class GaussianParallelRandomDefaultLM : public DefaultLossModel {
+    public:
+        GaussianParallelRandomDefaultLM(
+            const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+            const std::vector<std::vector<QuantLib::Real> >& factorWeights,
+            const std::vector<QuantLib::Real>& recoveryRates,
+            const QuantLib::Size numSims,
+            const long seed,
+            const QuantLib::Size threads,
+            bool permanent
+            );
+    };
+
+    class TParallelRandomDefaultLM : public DefaultLossModel {
+    public:
+        TParallelRandomDefaultLM(
+            const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+            const std::vector<std::vector<QuantLib::Real> >& factorWeights,
+            const std::vector<QuantLib::Real>& recoveryRates,
+            const std::vector<QuantLib::Real>& copulaInitVals,
+            const QuantLib::Size numSims,
+            const long seed,
+            const QuantLib::Size threads,
+            bool permanent
+            );
+    };
+
     class SaddlePointLossModel : public DefaultLossModel {
     public:
         SaddlePointLossModel(
@@ -187,6 +215,7 @@ namespace QuantLibAddin {
             const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
             const std::vector<std::vector<QuantLib::Real> >& factorWeights,
             const std::vector<QuantLib::Real>& recoveryRates,
+            bool batched,
             bool permanent
             );
     };
@@ -41,6 +41,7 @@
 
 #include <oh/repository.hpp>
 
+#include <algorithm>
 #include <ostream>
 
 using std::vector;
@@ -54,13 +55,14 @@ using boost::dynamic_pointer_cast;
 
 namespace QuantLibAddin {
 
-    vector<vector<property_t> > Bond::flowAnalysis(const Date& d)
+    vector<vector<property_t> > Bond::flowAnalysis(const Date& d,
+                                                   const vector<string>& columns)
     {
         shared_ptr<QuantLib::Bond> temp;
         getLibraryObject(temp);
         const QuantLib::Leg& cashflows = temp->cashflows();
 
-        return QuantLibAddin::flowAnalysis(cashflows, d);
+        return QuantLibAddin::flowAnalysis(cashflows, d, columns);
     }
 
     QuantLib::Real Bond::redemptionAmount() {
@@ -406,11 +408,19 @@ namespace QuantLibAddin {
             bool operator()(const BondItem& item1,
                             const BondItem& item2) const
             {
-                if (item1.maturityDate>item2.maturityDate)
-                    return false;
-                return true;
+                return item1.maturityDate<item2.maturityDate;
             }
         };
+
+        class BondPositionSorter {
+          public:
+            BondPositionSorter(const vector<BondItem>& items) : items_(items) {}
+            bool operator()(Size i, Size j) const {
+                return items_[i].maturityDate<items_[j].maturityDate;
+            }
+          private:
+            const vector<BondItem>& items_;
+        };
     }
 
     vector<string> qlBondMaturitySort(const vector<shared_ptr<Bond> >& bonds)
@@ -432,7 +442,7 @@ namespace QuantLibAddin {
         }
 
         // sort BondItems
-        std::sort(bondItems.begin(), bondItems.end(), BondItemSorter());
+        std::stable_sort(bondItems.begin(), bondItems.end(), BondItemSorter());
 
         // fill result
         std::vector<string> result(n);
@@ -441,4 +451,95 @@ namespace QuantLibAddin {
         return result;
     }
 
+    vector<vector<QuantLib::Real> > qlBondFlowLadder(
+                                        const vector<shared_ptr<Bond> >& bonds,
+                                        const vector<Date>& bucketDates,
+                                        const Date& afterDate)
+    {
+        vector<shared_ptr<QuantLib::Bond> > qlBonds(bonds.size());
+        vector<const QuantLib::Leg*> legs(bonds.size());
+        for (Size i=0; i<bonds.size(); ++i) {
+            bonds[i]->getLibraryObject(qlBonds[i]);
+            legs[i] = &qlBonds[i]->cashflows();
+        }
+        return flowLadder(legs, bucketDates, afterDate);
+    }
+
+    BondUniverse::BondUniverse(
+            const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+            const vector<shared_ptr<Bond> >& bonds,
+            bool permanent)
+    : ObjectHandler::Object(properties, permanent) {
+        Size n = bonds.size();
+        vector<BondItem> bondItems(n);
+        vector<shared_ptr<QuantLib::Bond> > qlBonds(n);
+        for (Size i=0; i<n; ++i) {
+            bonds[i]->getLibraryObject(qlBonds[i]);
+            bondItems[i] = BondItem(convert2<string>(bonds[i]->propertyValue("OBJECTID")),
+                                    qlBonds[i]->maturityDate());
+        }
+        vector<Size> order(n);
+        for (Size i=0; i<n; ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), BondPositionSorter(bondItems));
+
+        maturities_.reserve(n);
+        ids_.reserve(n);
+        bonds_.reserve(n);
+        positions_.reserve(n);
+        for (Size k=0; k<n; ++k) {
+            Size i = order[k];
+            maturities_.push_back(bondItems[i].maturityDate);
+            ids_.push_back(bondItems[i].objectID);
+            bonds_.push_back(qlBonds[i]);
+            positions_.push_back(i);
+        }
+    }
+
+    vector<string> BondUniverse::alive(Date& refDate) {
+        if (refDate==Date())
+            refDate = QuantLib::Settings::instance().evaluationDate();
+        if (refDate==aliveDate_)
+            return alive_;
+
+        // bonds maturing on or before the reference date are expired
+        // whatever their settlement days; only later ones are checked
+        Size first = std::upper_bound(maturities_.begin(), maturities_.end(),
+                                      refDate) - maturities_.begin();
+        vector<std::pair<Size, Size> > alive;
+        alive.reserve(maturities_.size()-first);
+        for (Size k=first; k<maturities_.size(); ++k) {
+            if (bonds_[k]->settlementDate(refDate)<maturities_[k])
+                alive.push_back(std::make_pair(positions_[k], k));
+        }
+        // back to input order
+        std::sort(alive.begin(), alive.end());
+
+        alive_.clear();
+        alive_.reserve(alive.size());
+        for (Size i=0; i<alive.size(); ++i)
+            alive_.push_back(ids_[alive[i].second]);
+        aliveDate_ = refDate;
+        return alive_;
+    }
+
+    string BondUniverse::maturityLookup(const Date& maturity) const {
+        vector<Date>::const_iterator i =
+            std::lower_bound(maturities_.begin(), maturities_.end(), maturity);
+        if (i==maturities_.end() || *i!=maturity)
+            return string();
+        return ids_[i-maturities_.begin()];
+    }
+
+    vector<string> BondUniverse::maturityRange(const Date& from,
+                                               const Date& to) const {
+        Size first = std::lower_bound(maturities_.begin(), maturities_.end(),
+                                      from) - maturities_.begin();
+        Size last = std::upper_bound(maturities_.begin(), maturities_.end(),
+                                     to) - maturities_.begin();
+        if (first>=last)
+            return vector<string>();
+        return vector<string>(ids_.begin()+first, ids_.begin()+last);
+    }
+
 }
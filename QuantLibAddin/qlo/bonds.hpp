@@ -32,6 +32,7 @@
 #include <ql/instruments/bond.hpp>
 
 #include <string>
+#include <vector>
 
 namespace QuantLib {
     class FloatingRateCouponPricer;
@@ -58,7 +59,8 @@ namespace QuantLibAddin {
         void setCouponPricers(
             const std::vector<boost::shared_ptr<QuantLib::FloatingRateCouponPricer> >&);
         std::vector<std::vector<ObjectHandler::property_t> > flowAnalysis(
-                                                    const QuantLib::Date& d);
+                                const QuantLib::Date& d,
+                                const std::vector<std::string>& columns);
         Bond(const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
              const std::string& description,
              const QuantLib::Currency& currency,
@@ -197,6 +199,41 @@ namespace QuantLibAddin {
     std::vector<std::string> qlBondMaturitySort(
                         const std::vector<boost::shared_ptr<Bond> >& bonds);
 
+    // amounts paid by each bond in each bucket, see QuantLibAddin::flowLadder
+    std::vector<std::vector<QuantLib::Real> > qlBondFlowLadder(
+                        const std::vector<boost::shared_ptr<Bond> >& bonds,
+                        const std::vector<QuantLib::Date>& bucketDates,
+                        const QuantLib::Date& afterDate);
+
+    // A fixed set of bonds indexed by maturity, for repeated queries on
+    // a large universe.  Maturities are sorted once at construction (ties
+    // keep the input order); the alive bonds are cached for the last
+    // reference date, so that they are only determined again when the
+    // evaluation date moves.  Membership changes rebuild the object.
+    class BondUniverse : public ObjectHandler::Object {
+      public:
+        BondUniverse(const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+                     const std::vector<boost::shared_ptr<Bond> >& bonds,
+                     bool permanent);
+        // alive bonds in input order, as qlBondAlive
+        std::vector<std::string> alive(QuantLib::Date& refDate);
+        // first bond in input order with the given maturity, as qlBondMaturityLookup
+        std::string maturityLookup(const QuantLib::Date& maturity) const;
+        // bonds maturing in [from, to], by maturity
+        std::vector<std::string> maturityRange(const QuantLib::Date& from,
+                                               const QuantLib::Date& to) const;
+        // all bonds by maturity, as qlBondMaturitySort
+        const std::vector<std::string>& maturitySort() const { return ids_; }
+      private:
+        // parallel arrays, sorted by maturity
+        std::vector<QuantLib::Date> maturities_;
+        std::vector<std::string> ids_;
+        std::vector<boost::shared_ptr<QuantLib::Bond> > bonds_;
+        std::vector<QuantLib::Size> positions_;
+        QuantLib::Date aliveDate_;
+        std::vector<std::string> alive_;
+    };
+
 }
 
 #endif
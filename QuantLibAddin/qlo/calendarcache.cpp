@@ -0,0 +1,343 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <qlo/config.hpp>
+#endif
+#include <qlo/calendarcache.hpp>
+#include <qlo/enumerations/factories/calendarfactory.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace QuantLibAddin {
+
+    namespace {
+
+        QuantLib::Size bitCount(boost::uint64_t x) {
+            x = x - ((x >> 1) & 0x5555555555555555ULL);
+            x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+            x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            return static_cast<QuantLib::Size>((x * 0x0101010101010101ULL) >> 56);
+        }
+
+        // bits 0 to n-1
+        boost::uint64_t lowBits(QuantLib::BigInteger n) {
+            return n >= 64 ? ~boost::uint64_t(0) : (boost::uint64_t(1) << n) - 1;
+        }
+
+    }
+
+    QuantLib::Size CachedCalendar::Impl::Table::rank(QuantLib::BigInteger i) const {
+        QuantLib::BigInteger w = i/64, b = i%64;
+        QuantLib::Size result = counts[w];
+        if (b > 0)
+            result += bitCount(words[w] & lowBits(b));
+        return result;
+    }
+
+    CachedCalendar::Impl::Impl(const QuantLib::Calendar& calendar,
+                               QuantLib::Year firstYear,
+                               QuantLib::Year lastYear)
+    : calendar_(calendar), table_(0) {
+        rebuild(firstYear, lastYear);
+    }
+
+    void CachedCalendar::Impl::publish(const boost::shared_ptr<Table>& table) {
+        QuantLib::Size count = 0;
+        table->counts.resize(table->words.size() + 1);
+        for (QuantLib::Size w=0; w<table->words.size(); ++w) {
+            table->counts[w] = count;
+            count += bitCount(table->words[w]);
+        }
+        table->counts.back() = count;
+        tables_.push_back(table);
+        table_.store(table.get(), boost::memory_order_release);
+    }
+
+    void CachedCalendar::Impl::rebuild(QuantLib::Year firstYear,
+                                       QuantLib::Year lastYear) {
+        QuantLib::Date first(1, QuantLib::January, firstYear);
+        QuantLib::Date last(31, QuantLib::December, lastYear);
+        boost::shared_ptr<Table> table(new Table);
+        table->first = first.serialNumber();
+        table->last = last.serialNumber();
+        QuantLib::BigInteger days = last - first + 1;
+        table->words.resize((days + 63)/64, 0);
+        QuantLib::Date d = first;
+        for (QuantLib::BigInteger i=0; i<days; ++i, ++d) {
+            if (calendar_.isBusinessDay(d))
+                table->words[i/64] |= boost::uint64_t(1) << (i%64);
+        }
+        boost::mutex::scoped_lock lock(mutex_);
+        publish(table);
+    }
+
+    void CachedCalendar::Impl::refresh(const QuantLib::Date& d) {
+        boost::mutex::scoped_lock lock(mutex_);
+        const Table* current = table_.load(boost::memory_order_acquire);
+        QuantLib::BigInteger serial = d.serialNumber();
+        if (serial < current->first || serial > current->last)
+            return;
+        boost::shared_ptr<Table> table(new Table(*current));
+        QuantLib::BigInteger i = serial - table->first;
+        boost::uint64_t bit = boost::uint64_t(1) << (i%64);
+        if (calendar_.isBusinessDay(d))
+            table->words[i/64] |= bit;
+        else
+            table->words[i/64] &= ~bit;
+        publish(table);
+    }
+
+    QuantLib::Date CachedCalendar::Impl::advance(const QuantLib::Date& d,
+                                                 QuantLib::Integer n) const {
+        const Table* table = table_.load(boost::memory_order_acquire);
+        QuantLib::BigInteger serial = d.serialNumber();
+        if (serial < table->first || serial > table->last)
+            return QuantLib::Date();
+        QuantLib::BigInteger size = table->last - table->first + 1;
+        QuantLib::BigInteger i = serial - table->first;
+        QuantLib::Size remaining = std::abs(n);
+        if (n > 0) {
+            // whole words are skipped by counting their business days;
+            // the bits after the last day are never set
+            for (QuantLib::BigInteger k = i+1; k < size; ) {
+                QuantLib::BigInteger w = k/64;
+                boost::uint64_t bits = table->words[w] >> (k%64);
+                QuantLib::Size available = bitCount(bits);
+                if (available < remaining) {
+                    remaining -= available;
+                    k = (w+1)*64;
+                    continue;
+                }
+                for (;; ++k, bits >>= 1) {
+                    if ((bits & 1) && --remaining == 0)
+                        return QuantLib::Date(table->first + k);
+                }
+            }
+        } else {
+            for (QuantLib::BigInteger k = i-1; k >= 0; ) {
+                QuantLib::BigInteger w = k/64;
+                boost::uint64_t bits = table->words[w] & lowBits(k%64 + 1);
+                QuantLib::Size available = bitCount(bits);
+                if (available < remaining) {
+                    remaining -= available;
+                    k = w*64 - 1;
+                    continue;
+                }
+                for (;; --k) {
+                    if (((bits >> (k%64)) & 1) && --remaining == 0)
+                        return QuantLib::Date(table->first + k);
+                }
+            }
+        }
+        return QuantLib::Date();
+    }
+
+    bool CachedCalendar::Impl::businessDaysBetween(const QuantLib::Date& from,
+                                                   const QuantLib::Date& to,
+                                                   bool includeFirst,
+                                                   bool includeLast,
+                                                   long& result) const {
+        const Table* table = table_.load(boost::memory_order_acquire);
+        QuantLib::BigInteger i = from.serialNumber() - table->first,
+                             j = to.serialNumber() - table->first,
+                             size = table->last - table->first + 1;
+        if (i < 0 || i >= size || j < 0 || j >= size)
+            return false;
+        // business days in [min, max], then the ends as in
+        // Calendar::businessDaysBetween
+        QuantLib::BigInteger lo = std::min(i, j), hi = std::max(i, j);
+        long days = static_cast<long>(table->rank(hi + 1) - table->rank(lo));
+        if (i == j) {
+            result = (includeFirst && includeLast) ? days : 0;
+            return true;
+        }
+        if (!includeFirst && table->isBusinessDay(i))
+            --days;
+        if (!includeLast && table->isBusinessDay(j))
+            --days;
+        result = i < j ? days : -days;
+        return true;
+    }
+
+    CachedCalendar::CachedCalendar(const QuantLib::Calendar& calendar,
+                                   QuantLib::Year firstYear,
+                                   QuantLib::Year lastYear)
+    : cachedImpl_(new Impl(calendar, firstYear, lastYear)) {
+        impl_ = cachedImpl_;
+    }
+
+    const QuantLib::Calendar& CachedCalendar::underlying() const {
+        return cachedImpl_->calendar_;
+    }
+
+    void CachedCalendar::rebuild(QuantLib::Year firstYear,
+                                 QuantLib::Year lastYear) {
+        cachedImpl_->rebuild(firstYear, lastYear);
+    }
+
+    void CachedCalendar::refresh(const QuantLib::Date& d) {
+        cachedImpl_->refresh(d);
+    }
+
+    const CachedCalendar::Impl* CachedCalendar::cachedImpl(
+                                        const QuantLib::Calendar& calendar) {
+        // Calendar::impl_ is protected; naming it through this class gives
+        // access to it for any calendar
+        boost::shared_ptr<QuantLib::Calendar::Impl> QuantLib::Calendar::* impl =
+            &CachedCalendar::impl_;
+        return dynamic_cast<const Impl*>((calendar.*impl).get());
+    }
+
+    QuantLib::Date CachedCalendar::advance(const QuantLib::Calendar& calendar,
+                                           const QuantLib::Date& d,
+                                           const QuantLib::Period& period,
+                                           QuantLib::BusinessDayConvention convention,
+                                           bool endOfMonth) {
+        // other units only adjust the result, which takes a few checks
+        if (period.units() == QuantLib::Days && period.length() != 0) {
+            if (const Impl* impl = cachedImpl(calendar)) {
+                QuantLib::Date result = impl->advance(d, period.length());
+                if (result != QuantLib::Date())
+                    return result;
+            }
+        }
+        return calendar.advance(d, period, convention, endOfMonth);
+    }
+
+    long CachedCalendar::businessDaysBetween(const QuantLib::Calendar& calendar,
+                                             const QuantLib::Date& from,
+                                             const QuantLib::Date& to,
+                                             bool includeFirst,
+                                             bool includeLast) {
+        long days;
+        if (const Impl* impl = cachedImpl(calendar)) {
+            if (impl->businessDaysBetween(from, to, includeFirst, includeLast, days))
+                return days;
+        }
+        return calendar.businessDaysBetween(from, to, includeFirst, includeLast);
+    }
+
+    CalendarCache& CalendarCache::instance() {
+        static CalendarCache cache;
+        return cache;
+    }
+
+    CalendarCache::CalendarCache()
+    : firstYear_(1990), lastYear_(2100), holidayChanges_(0) {}
+
+    bool CalendarCache::find(const std::string& id,
+                             QuantLib::Calendar& calendar) {
+        boost::mutex::scoped_lock lock(mutex_);
+        std::map<std::string, CachedCalendar>::const_iterator i = byId_.find(id);
+        if (i == byId_.end())
+            return false;
+        calendar = i->second;
+        return true;
+    }
+
+    QuantLib::Calendar CalendarCache::insert(const std::string& id,
+                                             const std::string& normalisedId,
+                                             const QuantLib::Calendar& calendar) {
+        boost::mutex::scoped_lock lock(mutex_);
+        std::map<std::string, CachedCalendar>::iterator i =
+            byNormalisedId_.find(normalisedId);
+        if (i == byNormalisedId_.end())
+            i = byNormalisedId_.insert(std::make_pair(normalisedId,
+                    CachedCalendar(calendar, firstYear_, lastYear_))).first;
+        byId_.insert(std::make_pair(id, i->second));
+        return i->second;
+    }
+
+    QuantLib::Calendar CalendarCache::underlying(const std::string& id) {
+        QuantLib::Calendar calendar = ObjectHandler::Create<QuantLib::Calendar>()(id);
+        boost::mutex::scoped_lock lock(mutex_);
+        std::map<std::string, CachedCalendar>::const_iterator i = byId_.find(id);
+        return i == byId_.end() ? calendar : i->second.underlying();
+    }
+
+    void CalendarCache::refresh(const QuantLib::Date& d) {
+        boost::mutex::scoped_lock lock(mutex_);
+        // byId_ shares the calendars of byNormalisedId_; any of them might
+        // be a joint calendar depending on the one that changed
+        for (std::map<std::string, CachedCalendar>::iterator i = byNormalisedId_.begin();
+             i != byNormalisedId_.end(); ++i)
+            i->second.refresh(d);
+        ++holidayChanges_;
+    }
+
+    QuantLib::Size CalendarCache::holidayChanges() const {
+        boost::mutex::scoped_lock lock(mutex_);
+        return holidayChanges_;
+    }
+
+    void CalendarCache::setYears(QuantLib::Year firstYear,
+                                 QuantLib::Year lastYear) {
+        QL_REQUIRE(firstYear <= lastYear,
+                   "first year (" << firstYear << ") after last year ("
+                   << lastYear << ")");
+        QL_REQUIRE(firstYear >= QuantLib::Date::minDate().year() &&
+                   lastYear <= QuantLib::Date::maxDate().year(),
+                   "years must be between " << QuantLib::Date::minDate().year()
+                   << " and " << QuantLib::Date::maxDate().year());
+        boost::mutex::scoped_lock lock(mutex_);
+        firstYear_ = firstYear;
+        lastYear_ = lastYear;
+        for (std::map<std::string, CachedCalendar>::iterator i = byNormalisedId_.begin();
+             i != byNormalisedId_.end(); ++i)
+            i->second.rebuild(firstYear_, lastYear_);
+    }
+
+    void qlCalendarAddHoliday(const std::string& calendarId,
+                              const QuantLib::Date& d) {
+        // holidays belong to the underlying calendar, as seen by the
+        // joint calendars built on it
+        CalendarCache::instance().underlying(calendarId).addHoliday(d);
+        CalendarCache::instance().refresh(d);
+    }
+
+    void qlCalendarRemoveHoliday(const std::string& calendarId,
+                                 const QuantLib::Date& d) {
+        CalendarCache::instance().underlying(calendarId).removeHoliday(d);
+        CalendarCache::instance().refresh(d);
+    }
+
+    void qlCalendarSetCachedYears(QuantLib::Year firstYear,
+                                  QuantLib::Year lastYear) {
+        CalendarCache::instance().setYears(firstYear, lastYear);
+    }
+
+    QuantLib::Date qlCalendarAdvance(const QuantLib::Calendar& calendar,
+                                     const QuantLib::Date& startDate,
+                                     const QuantLib::Period& period,
+                                     QuantLib::BusinessDayConvention convention,
+                                     bool endOfMonth) {
+        return CachedCalendar::advance(calendar, startDate, period,
+                                       convention, endOfMonth);
+    }
+
+    long qlCalendarBusinessDaysBetween(const QuantLib::Calendar& calendar,
+                                       const QuantLib::Date& firstDate,
+                                       const QuantLib::Date& lastDate,
+                                       bool includeFirst,
+                                       bool includeLast) {
+        return CachedCalendar::businessDaysBetween(calendar, firstDate, lastDate,
+                                                   includeFirst, includeLast);
+    }
+
+}
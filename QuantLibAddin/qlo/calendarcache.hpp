@@ -0,0 +1,198 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Cache of the calendars created from their IDs
+*/
+
+#ifndef qla_calendarcache_hpp
+#define qla_calendarcache_hpp
+
+#include <ql/time/calendar.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace QuantLibAddin {
+
+    //! Calendar reading business days from a precomputed table.
+    /*! Business days between the first and last year of the table are
+        stored as one bit per day, so that a holiday check costs a bit
+        test whatever the rules of the underlying calendar (or calendars,
+        for a joint calendar).  Dates outside the table are checked
+        against the underlying calendar.
+
+        The table is a snapshot: holidays added to or removed from the
+        underlying calendar are only seen after refresh() is called for
+        the date concerned, as done by qlCalendarAddHoliday and
+        qlCalendarRemoveHoliday.  Tables are never modified once built;
+        rebuild() and refresh() publish a new one through an atomic
+        pointer, so that threads checking dates meanwhile keep reading a
+        consistent table without taking a lock or a reference.  For the
+        same reason superseded tables are only released with the calendar;
+        they take about 10kB each for the default years.
+
+        Calendar::advance and Calendar::businessDaysBetween are not
+        virtual and step through the days one at a time; advance() and
+        businessDaysBetween() below count business days on the table a
+        word of 64 days at a time instead.
+    */
+    class CachedCalendar : public QuantLib::Calendar {
+      public:
+        CachedCalendar(const QuantLib::Calendar& calendar,
+                       QuantLib::Year firstYear,
+                       QuantLib::Year lastYear);
+        const QuantLib::Calendar& underlying() const;
+        void rebuild(QuantLib::Year firstYear, QuantLib::Year lastYear);
+        //! Read the given date again from the underlying calendar.
+        void refresh(const QuantLib::Date& d);
+
+        //! Same as calendar.advance(d, period, convention, endOfMonth).
+        /*! Business days are read from the table when the calendar is a
+            CachedCalendar and the result lies within the table.
+        */
+        static QuantLib::Date advance(const QuantLib::Calendar& calendar,
+                                      const QuantLib::Date& d,
+                                      const QuantLib::Period& period,
+                                      QuantLib::BusinessDayConvention convention,
+                                      bool endOfMonth);
+        //! Same as calendar.businessDaysBetween(from, to, includeFirst, includeLast).
+        /*! Business days are counted on the table when the calendar is a
+            CachedCalendar and both dates lie within the table.
+        */
+        static long businessDaysBetween(const QuantLib::Calendar& calendar,
+                                        const QuantLib::Date& from,
+                                        const QuantLib::Date& to,
+                                        bool includeFirst,
+                                        bool includeLast);
+      private:
+        class Impl : public QuantLib::Calendar::Impl {
+          public:
+            Impl(const QuantLib::Calendar& calendar,
+                 QuantLib::Year firstYear,
+                 QuantLib::Year lastYear);
+            std::string name() const { return calendar_.name(); }
+            bool isWeekend(QuantLib::Weekday w) const {
+                return calendar_.isWeekend(w);
+            }
+            bool isBusinessDay(const QuantLib::Date& d) const {
+                const Table* table = table_.load(boost::memory_order_acquire);
+                QuantLib::BigInteger serial = d.serialNumber();
+                if (serial >= table->first && serial <= table->last)
+                    return table->isBusinessDay(serial - table->first);
+                return calendar_.isBusinessDay(d);
+            }
+            void rebuild(QuantLib::Year firstYear, QuantLib::Year lastYear);
+            void refresh(const QuantLib::Date& d);
+            //! n-th business day after (n > 0) or before (n < 0) the given
+            //! date, or a null date if the table does not reach it.
+            QuantLib::Date advance(const QuantLib::Date& d,
+                                   QuantLib::Integer n) const;
+            //! As Calendar::businessDaysBetween; false if the table does
+            //! not cover both dates.
+            bool businessDaysBetween(const QuantLib::Date& from,
+                                     const QuantLib::Date& to,
+                                     bool includeFirst, bool includeLast,
+                                     long& result) const;
+            QuantLib::Calendar calendar_;
+          private:
+            // bit i%64 of words[i/64] is set if day first+i is a business
+            // day; counts[w] is the number of business days before word w
+            struct Table {
+                QuantLib::BigInteger first, last;
+                std::vector<boost::uint64_t> words;
+                std::vector<QuantLib::Size> counts;
+                bool isBusinessDay(QuantLib::BigInteger i) const {
+                    return ((words[i/64] >> (i%64)) & 1) != 0;
+                }
+                //! business days before day first+i
+                QuantLib::Size rank(QuantLib::BigInteger i) const;
+            };
+            void publish(const boost::shared_ptr<Table>& table);
+            boost::atomic<const Table*> table_;
+            // writers only; keeps the tables alive for lock-free readers
+            boost::mutex mutex_;
+            std::vector<boost::shared_ptr<const Table> > tables_;
+        };
+        static const Impl* cachedImpl(const QuantLib::Calendar& calendar);
+        boost::shared_ptr<Impl> cachedImpl_;
+    };
+
+    //! Calendars created by the addin, by ID.
+    /*! Each calendar is stored under the ID it was requested with and
+        under its normalised ID (upper case, and for joint calendars the
+        canonical form built by the factory), so that repeated requests
+        skip parsing and different spellings share one calendar.
+    */
+    class CalendarCache {
+      public:
+        static CalendarCache& instance();
+        //! Calendar stored under the given ID, if any.
+        bool find(const std::string& id, QuantLib::Calendar& calendar);
+        //! Store the given calendar, unless one exists for the normalised ID.
+        /*! Returns the calendar to be used for the given ID. */
+        QuantLib::Calendar insert(const std::string& id,
+                                  const std::string& normalisedId,
+                                  const QuantLib::Calendar& calendar);
+        //! Underlying calendar stored under the given ID.
+        QuantLib::Calendar underlying(const std::string& id);
+        //! Update the business-day tables after a holiday was added or removed.
+        void refresh(const QuantLib::Date& d);
+        //! Number of holiday changes so far, for caches of dates
+        //! generated with the calendars.
+        QuantLib::Size holidayChanges() const;
+        //! Change the years covered by the business-day tables.
+        void setYears(QuantLib::Year firstYear, QuantLib::Year lastYear);
+      private:
+        CalendarCache();
+        mutable boost::mutex mutex_;
+        std::map<std::string, CachedCalendar> byId_, byNormalisedId_;
+        QuantLib::Year firstYear_, lastYear_;
+        QuantLib::Size holidayChanges_;
+    };
+
+    /*! add a holiday to the calendar with the given ID */
+    void qlCalendarAddHoliday(const std::string& calendarId,
+                              const QuantLib::Date& d);
+    /*! remove a holiday from the calendar with the given ID */
+    void qlCalendarRemoveHoliday(const std::string& calendarId,
+                                 const QuantLib::Date& d);
+    /*! set the years covered by the business-day tables of calendars */
+    void qlCalendarSetCachedYears(QuantLib::Year firstYear,
+                                  QuantLib::Year lastYear);
+    /*! advance a date according to the given calendar */
+    QuantLib::Date qlCalendarAdvance(const QuantLib::Calendar& calendar,
+                                     const QuantLib::Date& startDate,
+                                     const QuantLib::Period& period,
+                                     QuantLib::BusinessDayConvention convention,
+                                     bool endOfMonth);
+    /*! number of business days between two dates */
+    long qlCalendarBusinessDaysBetween(const QuantLib::Calendar& calendar,
+                                       const QuantLib::Date& firstDate,
+                                       const QuantLib::Date& lastDate,
+                                       bool includeFirst,
+                                       bool includeLast);
+
+}
+
+#endif
@@ -22,6 +22,7 @@
 #endif
 
 #include <qlo/calibrationhelpers.hpp>
+#include <qlo/pricingengines.hpp>
 
 #include <ql/indexes/iborindex.hpp>
 #include <ql/models/shortrate/calibrationhelpers/swaptionhelper.hpp>
@@ -50,6 +51,17 @@ namespace QuantLibAddin {
     //    }
     //}
 
+    void BlackCalibrationHelper::setPricingEngine(
+                            boost::shared_ptr<PricingEngine>& engine) const {
+        boost::shared_ptr<QuantLib::PricingEngine> ql_engine;
+        engine->getLibraryObject(ql_engine);
+
+        libraryObject_->setPricingEngine(ql_engine);
+
+        std::string engineId = engine->properties()->objectId();
+        properties()->setProperty("EngineID", engineId);
+    }
+
     SwaptionHelper::SwaptionHelper(const shared_ptr<ObjectHandler::ValueObject>& properties,
                                    const QuantLib::Period& maturity,
                                    const QuantLib::Period& length,
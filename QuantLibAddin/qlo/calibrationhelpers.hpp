@@ -39,8 +39,12 @@ namespace QuantLib {
 
 namespace QuantLibAddin {
 
+    class PricingEngine;
+
     class BlackCalibrationHelper : public ObjectHandler::LibraryObject<QuantLib::BlackCalibrationHelper> {
-      //public:
+      public:
+        //! Set the pricing engine and record its ID as the EngineID property.
+        void setPricingEngine(boost::shared_ptr<PricingEngine>& engine) const;
       //  std::string quoteName() { return quoteName_; }
       protected:
           OH_LIB_CTOR(BlackCalibrationHelper, QuantLib::BlackCalibrationHelper);
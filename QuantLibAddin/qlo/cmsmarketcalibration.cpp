@@ -24,8 +24,7 @@
 #include <qlo/cmsmarketcalibration.hpp>
 #include <qlo/cmsmarket.hpp>
 #include <qlo/swaptionvolstructure.hpp>
-
-#include <boost/timer.hpp>
+#include <qlo/parallel.hpp>
 
 using boost::shared_ptr;
 using ObjectHandler::LibraryObject;
@@ -70,13 +69,15 @@ namespace QuantLibAddin {
                                  const shared_ptr<OptimizationMethod>& method,
                                  const QuantLib::Array& guess,
                                  bool isMeanReversionFixed) {
-        boost::timer t;
-        t.restart();
+        QL_REQUIRE(!guess.empty() || !lastSolution_.empty(),
+                   "no guess given and no previous solution available");
+        WallTimer t;
         QuantLib::Array result = libraryObject_->compute(endCriteria,
                                 method,
-                                guess,
+                                guess.empty() ? lastSolution_ : guess,
                                 isMeanReversionFixed);
         elapsed_ = t.elapsed();
+        lastSolution_ = result;
         return result;
    }
 
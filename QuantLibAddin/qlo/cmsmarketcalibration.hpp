@@ -60,12 +60,17 @@ namespace QuantLibAddin {
         std::vector<std::vector<ObjectHandler::property_t> > getDenseSabrParameters();
         std::vector<std::vector<ObjectHandler::property_t> > getCmsMarket();
         QuantLib::Real elapsed() {return elapsed_ ; }
+        //! Run the calibration.
+        /*! An empty guess restarts from the solution of the previous
+            run, e.g. after the market data has moved.
+        */
         QuantLib::Array compute(const boost::shared_ptr<QuantLib::EndCriteria>& endCriteria,
                                 const boost::shared_ptr<QuantLib::OptimizationMethod>& method,
                                 const QuantLib::Array& guess,
                                 bool isMeanReversionFixed);
       private:
         QuantLib::Real elapsed_;
+        QuantLib::Array lastSolution_;
     }; 
 }
 
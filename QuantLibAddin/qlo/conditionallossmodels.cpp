@@ -0,0 +1,443 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)
+    #include <qlo/config.hpp>
+#endif
+
+#include <qlo/conditionallossmodels.hpp>
+#include <qlo/mathf.hpp>
+
+#include <ql/experimental/credit/basket.hpp>
+#include <ql/math/distributions/bivariatenormaldistribution.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/integrals/gaussianquadratures.hpp>
+#include <ql/mathconstants.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace QuantLibAddin {
+
+    namespace {
+
+        // P(X <= x, Y <= y) for standard normals with the given
+        // correlation, QL_MAX_REAL standing for an unbounded y
+        QuantLib::Real bivariateNormal(QuantLib::Real x, QuantLib::Real y,
+                                       QuantLib::Real correlation) {
+            if (y == QL_MAX_REAL)
+                return QuantLib::CumulativeNormalDistribution()(x);
+            return QuantLib::BivariateCumulativeNormalDistribution(
+                                                         correlation)(x, y);
+        }
+
+    }
+
+    BatchedGaussianLHPLossModel::BatchedGaussianLHPLossModel(
+                            QuantLib::Real correlation,
+                            const std::vector<QuantLib::Real>& recoveries)
+    : beta_(std::sqrt(correlation)), sigma_(std::sqrt(1.0 - correlation)),
+      recoveries_(recoveries) {
+        QL_REQUIRE(correlation > 0.0 && correlation < 1.0,
+                   "correlation (" << correlation << ") must be in (0, 1)");
+        QL_REQUIRE(!recoveries_.empty(), "no recovery rates given");
+    }
+
+    boost::shared_ptr<const BatchedGaussianLHPLossModel::Pool>
+    BatchedGaussianLHPLossModel::pool(const QuantLib::Date& d) const {
+        boost::shared_ptr<Pool> current(new Pool);
+        current->probabilities = basket_->remainingProbabilities(d);
+        current->notionals = basket_->remainingNotionals(d);
+        QL_REQUIRE(current->probabilities.size() == recoveries_.size(),
+                   "number of live names (" << current->probabilities.size()
+                   << ") does not match the number of recovery rates ("
+                   << recoveries_.size() << ")");
+
+        boost::mutex::scoped_lock lock(mutex_);
+        std::map<QuantLib::Date, boost::shared_ptr<const Pool> >::iterator
+            cached = pools_.find(d);
+        if (cached != pools_.end() &&
+            cached->second->probabilities == current->probabilities &&
+            cached->second->notionals == current->notionals)
+            return cached->second;
+
+        QuantLib::Real notional = 0.0, probability = 0.0, recovery = 0.0;
+        for (QuantLib::Size i=0; i<recoveries_.size(); ++i) {
+            notional += current->notionals[i];
+            probability += current->notionals[i] * current->probabilities[i];
+            recovery += current->notionals[i] * recoveries_[i];
+        }
+        QL_REQUIRE(notional > 0.0, "no live notional left in the basket");
+        current->notional = notional;
+        current->probability = probability / notional;
+        current->recovery = recovery / notional;
+        if (current->probability <= 0.0)
+            current->threshold = -QL_MAX_REAL;
+        else if (current->probability >= 1.0)
+            current->threshold = QL_MAX_REAL;
+        else
+            current->threshold = normSInv(current->probability);
+        pools_[d] = current;
+        return current;
+    }
+
+    QuantLib::Real BatchedGaussianLHPLossModel::factorLevel(
+                                const Pool& pool, QuantLib::Real k) const {
+        QuantLib::Real maxLoss = 1.0 - pool.recovery;
+        if (k <= 0.0)
+            return QL_MAX_REAL;
+        if (k >= maxLoss)
+            return -QL_MAX_REAL;
+        return (pool.threshold - sigma_ * normSInv(k / maxLoss)) / beta_;
+    }
+
+    QuantLib::Real BatchedGaussianLHPLossModel::lossOver(
+                                const Pool& pool, QuantLib::Real k,
+                                QuantLib::Real zeta) const {
+        QuantLib::Real maxLoss = 1.0 - pool.recovery;
+        if (k >= maxLoss || pool.probability <= 0.0)
+            return 0.0;
+        if (pool.probability >= 1.0)
+            return zeta == QL_MAX_REAL ? maxLoss - k
+                : (maxLoss - k) * QuantLib::CumulativeNormalDistribution()(zeta);
+        QuantLib::Real z = std::min(zeta, factorLevel(pool, k));
+        QuantLib::Real below = z == QL_MAX_REAL ? 1.0
+            : QuantLib::CumulativeNormalDistribution()(z);
+        return maxLoss * bivariateNormal(pool.threshold, z, beta_)
+            - k * below;
+    }
+
+    QuantLib::Real BatchedGaussianLHPLossModel::trancheLoss(
+                                                QuantLib::Real loss) const {
+        QuantLib::Real attachment = basket_->remainingAttachmentAmount(),
+                       detachment = basket_->remainingDetachmentAmount();
+        return std::min(std::max(loss - attachment, 0.0),
+                        detachment - attachment);
+    }
+
+    QuantLib::Real BatchedGaussianLHPLossModel::expectedTrancheLoss(
+                                            const QuantLib::Date& d) const {
+        boost::shared_ptr<const Pool> p = pool(d);
+        QuantLib::Real a = std::min(
+            basket_->remainingAttachmentAmount() / p->notional, 1.0);
+        QuantLib::Real b = std::min(
+            basket_->remainingDetachmentAmount() / p->notional, 1.0);
+        return p->notional * (lossOver(*p, a, QL_MAX_REAL)
+                              - lossOver(*p, b, QL_MAX_REAL));
+    }
+
+    QuantLib::Probability BatchedGaussianLHPLossModel::probOverLoss(
+                                            const QuantLib::Date& d,
+                                            QuantLib::Real lossFraction) const {
+        QL_REQUIRE(lossFraction >= 0.0 && lossFraction <= 1.0,
+                   "loss fraction (" << lossFraction << ") out of range");
+        boost::shared_ptr<const Pool> p = pool(d);
+        QuantLib::Real attachment = basket_->remainingAttachmentAmount(),
+                       detachment = basket_->remainingDetachmentAmount();
+        QuantLib::Real k =
+            (attachment + lossFraction * (detachment - attachment))
+            / p->notional;
+        if (k <= 0.0)
+            return 1.0;
+        if (p->probability <= 0.0 || k >= 1.0 - p->recovery)
+            return 0.0;
+        if (p->probability >= 1.0)
+            return 1.0;
+        return QuantLib::CumulativeNormalDistribution()(factorLevel(*p, k));
+    }
+
+    QuantLib::Real BatchedGaussianLHPLossModel::percentile(
+                                            const QuantLib::Date& d,
+                                            QuantLib::Real percentile) const {
+        QL_REQUIRE(percentile >= 0.0 && percentile <= 1.0,
+                   "percentile (" << percentile << ") out of range");
+        boost::shared_ptr<const Pool> p = pool(d);
+        QuantLib::Real maxLoss = 1.0 - p->recovery;
+        QuantLib::Real fraction;
+        if (percentile <= 0.0 || p->probability <= 0.0)
+            fraction = 0.0;
+        else if (percentile >= 1.0 || p->probability >= 1.0)
+            fraction = maxLoss;
+        else
+            fraction = maxLoss * normSDist(
+                (p->threshold + beta_ * normSInv(percentile)) / sigma_);
+        return trancheLoss(p->notional * fraction);
+    }
+
+    QuantLib::Real BatchedGaussianLHPLossModel::expectedShortfall(
+                                            const QuantLib::Date& d,
+                                            QuantLib::Real percentile) const {
+        QL_REQUIRE(percentile >= 0.0 && percentile < 1.0,
+                   "percentile (" << percentile << ") out of range");
+        boost::shared_ptr<const Pool> p = pool(d);
+        QuantLib::Real a = std::min(
+            basket_->remainingAttachmentAmount() / p->notional, 1.0);
+        QuantLib::Real b = std::min(
+            basket_->remainingDetachmentAmount() / p->notional, 1.0);
+        // the tranche loss decreases with the market factor
+        QuantLib::Real zeta = percentile <= 0.0 ? QL_MAX_REAL
+            : -normSInv(percentile);
+        return p->notional * (lossOver(*p, a, zeta) - lossOver(*p, b, zeta))
+            / (1.0 - percentile);
+    }
+
+    void BatchedGaussianLHPLossModel::resetModel() {
+        boost::mutex::scoped_lock lock(mutex_);
+        pools_.clear();
+    }
+
+
+    BatchedRecursiveGaussLossModel::BatchedRecursiveGaussLossModel(
+            const std::vector<std::vector<QuantLib::Real> >& factorWeights,
+            const std::vector<QuantLib::Real>& recoveries,
+            QuantLib::Size buckets,
+            QuantLib::Size nodesPerFactor)
+    : names_(factorWeights.size()), buckets_(buckets),
+      recoveries_(recoveries), scales_(factorWeights.size()) {
+        QL_REQUIRE(names_ > 0, "no factor weights given");
+        QL_REQUIRE(recoveries_.size() == names_,
+                   "number of recovery rates (" << recoveries_.size()
+                   << ") does not match the number of names ("
+                   << names_ << ")");
+        QL_REQUIRE(buckets_ > 0, "at least one bucket required");
+        QL_REQUIRE(nodesPerFactor > 0, "at least one node required");
+        QuantLib::Size factors = factorWeights[0].size();
+        QL_REQUIRE(factors > 0, "no factors given");
+        for (QuantLib::Size i=0; i<names_; ++i) {
+            QL_REQUIRE(factorWeights[i].size() == factors,
+                       "name " << i << " has " << factorWeights[i].size()
+                       << " factor weights instead of " << factors);
+            QuantLib::Real sum = 0.0;
+            for (QuantLib::Size k=0; k<factors; ++k)
+                sum += factorWeights[i][k] * factorWeights[i][k];
+            QL_REQUIRE(sum < 1.0,
+                       "factor weights of name " << i << " too large");
+            scales_[i] = 1.0 / std::sqrt(1.0 - sum);
+        }
+
+        // tensor Gauss-Hermite grid for standard normal factors; the
+        // library weights integrate f(x) dx, hence the exp(-x^2) factor
+        QuantLib::GaussHermiteIntegration quadrature(nodesPerFactor);
+        std::vector<QuantLib::Real> x(nodesPerFactor), w(nodesPerFactor);
+        for (QuantLib::Size j=0; j<nodesPerFactor; ++j) {
+            QuantLib::Real node = quadrature.x()[j];
+            x[j] = M_SQRT2 * node;
+            w[j] = quadrature.weights()[j] * std::exp(-node*node) * M_1_SQRTPI;
+        }
+        QuantLib::Size nodes = 1;
+        for (QuantLib::Size k=0; k<factors; ++k)
+            nodes *= nodesPerFactor;
+        weights_.resize(nodes);
+        shifts_.resize(nodes * names_);
+        std::vector<QuantLib::Size> index(factors, 0);
+        for (QuantLib::Size m=0; m<nodes; ++m) {
+            weights_[m] = 1.0;
+            for (QuantLib::Size k=0; k<factors; ++k)
+                weights_[m] *= w[index[k]];
+            for (QuantLib::Size i=0; i<names_; ++i) {
+                QuantLib::Real y = 0.0;
+                for (QuantLib::Size k=0; k<factors; ++k)
+                    y += factorWeights[i][k] * x[index[k]];
+                shifts_[m*names_+i] = y * scales_[i];
+            }
+            for (QuantLib::Size k=0; k<factors; ++k) {
+                if (++index[k] < nodesPerFactor)
+                    break;
+                index[k] = 0;
+            }
+        }
+    }
+
+    boost::shared_ptr<const BatchedRecursiveGaussLossModel::Distribution>
+    BatchedRecursiveGaussLossModel::distribution(const QuantLib::Date& d) const {
+        boost::shared_ptr<Distribution> current(new Distribution);
+        current->probabilities = basket_->remainingProbabilities(d);
+        current->notionals = basket_->remainingNotionals(d);
+        QL_REQUIRE(current->probabilities.size() == names_,
+                   "number of live names (" << current->probabilities.size()
+                   << ") does not match the model size (" << names_ << ")");
+
+        // concurrent queries for the same date wait for one recursion
+        boost::mutex::scoped_lock lock(mutex_);
+        std::map<QuantLib::Date,
+                 boost::shared_ptr<const Distribution> >::iterator
+            cached = distributions_.find(d);
+        if (cached != distributions_.end() &&
+            cached->second->probabilities == current->probabilities &&
+            cached->second->notionals == current->notionals)
+            return cached->second;
+
+        // losses given default on the grid of loss units
+        std::vector<QuantLib::Real> lossGivenDefault(names_);
+        QuantLib::Real smallest = QL_MAX_REAL;
+        for (QuantLib::Size i=0; i<names_; ++i) {
+            lossGivenDefault[i] = current->notionals[i] * (1.0 - recoveries_[i]);
+            if (lossGivenDefault[i] > 0.0)
+                smallest = std::min(smallest, lossGivenDefault[i]);
+        }
+        current->unit = smallest == QL_MAX_REAL ? 1.0 : smallest / buckets_;
+        std::vector<QuantLib::Size> units(names_);
+        QuantLib::Size total = 0;
+        for (QuantLib::Size i=0; i<names_; ++i) {
+            units[i] = static_cast<QuantLib::Size>(
+                            lossGivenDefault[i] / current->unit + 0.5);
+            total += units[i];
+        }
+
+        // thresholds of all names in one batch, names that surely
+        // default or survive being kept out of the quadrature
+        std::vector<QuantLib::Real> inner(current->probabilities);
+        for (QuantLib::Size i=0; i<names_; ++i) {
+            if (inner[i] <= 0.0 || inner[i] >= 1.0)
+                inner[i] = 0.5;
+        }
+        std::vector<QuantLib::Real> thresholds(names_);
+        normSInv(&inner[0], &thresholds[0], names_);
+        for (QuantLib::Size i=0; i<names_; ++i)
+            thresholds[i] *= scales_[i];
+
+        // conditional default probabilities over all nodes and names
+        QuantLib::Size nodes = weights_.size();
+        std::vector<QuantLib::Real> conditional(nodes * names_);
+        QuantLib::CumulativeNormalDistribution cumulative;
+        for (QuantLib::Size m=0; m<nodes; ++m) {
+            const QuantLib::Real* shift = &shifts_[m*names_];
+            QuantLib::Real* q = &conditional[m*names_];
+            for (QuantLib::Size i=0; i<names_; ++i)
+                q[i] = thresholds[i] - shift[i];
+        }
+        for (QuantLib::Size j=0; j<conditional.size(); ++j)
+            conditional[j] = cumulative(conditional[j]);
+
+        current->density.assign(total + 1, 0.0);
+        std::vector<QuantLib::Real> losses(total + 1);
+        for (QuantLib::Size m=0; m<nodes; ++m) {
+            const QuantLib::Real* q = &conditional[m*names_];
+            std::fill(losses.begin(), losses.end(), 0.0);
+            losses[0] = 1.0;
+            QuantLib::Size reached = 0;
+            for (QuantLib::Size i=0; i<names_; ++i) {
+                QuantLib::Size k = units[i];
+                if (k == 0)
+                    continue;
+                QuantLib::Real p = q[i];
+                if (current->probabilities[i] <= 0.0)
+                    continue;
+                if (current->probabilities[i] >= 1.0)
+                    p = 1.0;
+                for (QuantLib::Size l=reached+1; l-- > 0; ) {
+                    losses[l+k] += losses[l] * p;
+                    losses[l] *= 1.0 - p;
+                }
+                reached += k;
+            }
+            for (QuantLib::Size l=0; l<=reached; ++l)
+                current->density[l] += weights_[m] * losses[l];
+        }
+        distributions_[d] = current;
+        return current;
+    }
+
+    QuantLib::Real BatchedRecursiveGaussLossModel::trancheLoss(
+                                                QuantLib::Real loss) const {
+        QuantLib::Real attachment = basket_->remainingAttachmentAmount(),
+                       detachment = basket_->remainingDetachmentAmount();
+        return std::min(std::max(loss - attachment, 0.0),
+                        detachment - attachment);
+    }
+
+    QuantLib::Real BatchedRecursiveGaussLossModel::expectedTrancheLoss(
+                                            const QuantLib::Date& d) const {
+        boost::shared_ptr<const Distribution> dist = distribution(d);
+        QuantLib::Real result = 0.0;
+        for (QuantLib::Size l=0; l<dist->density.size(); ++l)
+            result += dist->density[l] * trancheLoss(l * dist->unit);
+        return result;
+    }
+
+    QuantLib::Probability BatchedRecursiveGaussLossModel::probOverLoss(
+                                            const QuantLib::Date& d,
+                                            QuantLib::Real lossFraction) const {
+        QL_REQUIRE(lossFraction >= 0.0 && lossFraction <= 1.0,
+                   "loss fraction (" << lossFraction << ") out of range");
+        boost::shared_ptr<const Distribution> dist = distribution(d);
+        QuantLib::Real attachment = basket_->remainingAttachmentAmount(),
+                       detachment = basket_->remainingDetachmentAmount();
+        QuantLib::Real level =
+            attachment + lossFraction * (detachment - attachment);
+        QuantLib::Probability result = 0.0;
+        for (QuantLib::Size l=dist->density.size(); l-- > 0; ) {
+            if (l * dist->unit < level)
+                break;
+            result += dist->density[l];
+        }
+        return std::min(result, 1.0);
+    }
+
+    QuantLib::Real BatchedRecursiveGaussLossModel::percentile(
+                                            const QuantLib::Date& d,
+                                            QuantLib::Real percentile) const {
+        QL_REQUIRE(percentile >= 0.0 && percentile <= 1.0,
+                   "percentile (" << percentile << ") out of range");
+        boost::shared_ptr<const Distribution> dist = distribution(d);
+        QuantLib::Real cumulated = 0.0;
+        for (QuantLib::Size l=0; l<dist->density.size(); ++l) {
+            cumulated += dist->density[l];
+            if (cumulated >= percentile)
+                return trancheLoss(l * dist->unit);
+        }
+        return trancheLoss((dist->density.size() - 1) * dist->unit);
+    }
+
+    QuantLib::Real BatchedRecursiveGaussLossModel::expectedShortfall(
+                                            const QuantLib::Date& d,
+                                            QuantLib::Real percentile) const {
+        QL_REQUIRE(percentile >= 0.0 && percentile < 1.0,
+                   "percentile (" << percentile << ") out of range");
+        boost::shared_ptr<const Distribution> dist = distribution(d);
+        QuantLib::Real quantile = this->percentile(d, percentile);
+        // E[L 1{L > q}] + q (P(L <= q) - percentile), over 1 - percentile
+        QuantLib::Real tail = 0.0, below = 0.0;
+        for (QuantLib::Size l=0; l<dist->density.size(); ++l) {
+            QuantLib::Real loss = trancheLoss(l * dist->unit);
+            if (loss > quantile)
+                tail += dist->density[l] * loss;
+            else
+                below += dist->density[l];
+        }
+        return (tail + quantile * (below - percentile)) / (1.0 - percentile);
+    }
+
+    std::map<QuantLib::Real, QuantLib::Probability>
+    BatchedRecursiveGaussLossModel::lossDistribution(
+                                            const QuantLib::Date& d) const {
+        boost::shared_ptr<const Distribution> dist = distribution(d);
+        std::map<QuantLib::Real, QuantLib::Probability> result;
+        QuantLib::Real cumulated = 0.0;
+        for (QuantLib::Size l=0; l<dist->density.size(); ++l) {
+            cumulated += dist->density[l];
+            result[l * dist->unit] = std::min(cumulated, 1.0);
+        }
+        return result;
+    }
+
+    void BatchedRecursiveGaussLossModel::resetModel() {
+        boost::mutex::scoped_lock lock(mutex_);
+        distributions_.clear();
+    }
+
+}
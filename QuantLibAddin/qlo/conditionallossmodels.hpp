@@ -0,0 +1,141 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Gaussian loss models conditioning on the market factor in batches
+*/
+
+#ifndef qla_conditionallossmodels_hpp
+#define qla_conditionallossmodels_hpp
+
+#include <ql/experimental/credit/defaultlossmodel.hpp>
+#include <ql/time/date.hpp>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <vector>
+
+namespace QuantLibAddin {
+
+    //! Gaussian large homogeneous pool model in closed form.
+    /*! Same model as QuantLib::GaussianLHPLossModel: the live names are
+        replaced by a large pool with their notional-weighted average
+        default probability p and recovery R, whose loss fraction given the
+        market factor Z is \f$ (1-R) N((c - \sqrt{\rho} Z)/\sqrt{1-\rho}) \f$
+        with \f$ c = N^{-1}(p) \f$.  Expected tranche losses, exceedance
+        probabilities, percentiles and expected shortfalls follow from the
+        univariate and bivariate normal distributions.
+
+        The pool averages and the threshold c of each date are kept, and
+        only computed again when the default probabilities or notionals of
+        the basket have changed.
+    */
+    class BatchedGaussianLHPLossModel : public QuantLib::DefaultLossModel {
+      public:
+        BatchedGaussianLHPLossModel(QuantLib::Real correlation,
+                                    const std::vector<QuantLib::Real>& recoveries);
+        QuantLib::Real expectedTrancheLoss(const QuantLib::Date& d) const;
+        QuantLib::Probability probOverLoss(const QuantLib::Date& d,
+                                           QuantLib::Real lossFraction) const;
+        QuantLib::Real percentile(const QuantLib::Date& d,
+                                  QuantLib::Real percentile) const;
+        QuantLib::Real expectedShortfall(const QuantLib::Date& d,
+                                         QuantLib::Real percentile) const;
+      private:
+        struct Pool {
+            std::vector<QuantLib::Real> probabilities, notionals;
+            QuantLib::Real notional, probability, recovery, threshold;
+        };
+        boost::shared_ptr<const Pool> pool(const QuantLib::Date& d) const;
+        // E[(L-k)^+ 1{Z <= zeta}] for the pool loss fraction L
+        QuantLib::Real lossOver(const Pool& pool, QuantLib::Real k,
+                                QuantLib::Real zeta) const;
+        // Z below which the pool loss fraction exceeds k
+        QuantLib::Real factorLevel(const Pool& pool, QuantLib::Real k) const;
+        QuantLib::Real trancheLoss(QuantLib::Real loss) const;
+        void resetModel();
+
+        QuantLib::Real beta_, sigma_;
+        std::vector<QuantLib::Real> recoveries_;
+        mutable boost::mutex mutex_;
+        mutable std::map<QuantLib::Date, boost::shared_ptr<const Pool> > pools_;
+    };
+
+    //! Gaussian latent model with the recursive loss algorithm.
+    /*! Same model as QuantLib::RecursiveGaussLossModel: given the market
+        factors, the loss distribution of the basket on a grid of loss
+        units is built recursively name by name, and integrated over the
+        factors with a tensor Gauss-Hermite quadrature.  The loss unit is
+        the smallest loss given default of the live names divided by the
+        given number of buckets.
+
+        The default thresholds of all names are inverted in one batch; the
+        factor part of the conditional probabilities is computed once for
+        all nodes and names on construction, and the conditional
+        probabilities of a date are evaluated over all nodes and names in a
+        single pass before the recursion.  The loss distribution of each
+        date is kept and shared by all queries, and only computed again
+        when the default probabilities or notionals of the basket have
+        changed.
+    */
+    class BatchedRecursiveGaussLossModel : public QuantLib::DefaultLossModel {
+      public:
+        BatchedRecursiveGaussLossModel(
+            const std::vector<std::vector<QuantLib::Real> >& factorWeights,
+            const std::vector<QuantLib::Real>& recoveries,
+            QuantLib::Size buckets = 1,
+            QuantLib::Size nodesPerFactor = 32);
+        QuantLib::Real expectedTrancheLoss(const QuantLib::Date& d) const;
+        QuantLib::Probability probOverLoss(const QuantLib::Date& d,
+                                           QuantLib::Real lossFraction) const;
+        QuantLib::Real percentile(const QuantLib::Date& d,
+                                  QuantLib::Real percentile) const;
+        QuantLib::Real expectedShortfall(const QuantLib::Date& d,
+                                         QuantLib::Real percentile) const;
+        //! cumulative probabilities of the basket losses
+        std::map<QuantLib::Real, QuantLib::Probability>
+        lossDistribution(const QuantLib::Date& d) const;
+      private:
+        // probability of a basket loss of l units for each l
+        struct Distribution {
+            std::vector<QuantLib::Real> probabilities, notionals;
+            QuantLib::Real unit;
+            std::vector<QuantLib::Real> density;
+        };
+        boost::shared_ptr<const Distribution> distribution(
+                                            const QuantLib::Date& d) const;
+        QuantLib::Real trancheLoss(QuantLib::Real loss) const;
+        void resetModel();
+
+        QuantLib::Size names_, buckets_;
+        std::vector<QuantLib::Real> recoveries_;
+        // quadrature weight of each node
+        std::vector<QuantLib::Real> weights_;
+        // factor part of the conditional threshold, node by node
+        std::vector<QuantLib::Real> shifts_;
+        // inverse of the idiosyncratic volatility of each name
+        std::vector<QuantLib::Real> scales_;
+        mutable boost::mutex mutex_;
+        mutable std::map<QuantLib::Date,
+                         boost::shared_ptr<const Distribution> > distributions_;
+    };
+
+}
+
+#endif
@@ -34,6 +34,17 @@
 #include <ql/models/marketmodels/historicalforwardratesanalysis.hpp>
 #include <ql/models/marketmodels/historicalratesanalysis.hpp>
 #include <qlo/enumerations/factories/historicalforwardratesanalysisfactory.hpp>
+#include <qlo/piecewiseyieldcurve.hpp>
+#include <qlo/parallel.hpp>
+#include <ql/cashflows/couponpricer.hpp>
+#include <ql/cashflows/iborcoupon.hpp>
+#include <ql/indexes/iborindex.hpp>
+#include <ql/indexes/swapindex.hpp>
+#include <ql/math/matrix.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/settings.hpp>
+#include <ql/termstructures/yield/ratehelpers.hpp>
+#include <map>
 
 namespace QuantLibAddin {
       
@@ -96,6 +107,287 @@ namespace QuantLibAddin {
                                                     displacement));
     }
   
+    namespace {
+
+        // Ibor coupon pricer fixing the coupons of a swap helper as the serial
+        // analysis does with the evaluation date set to the date of the
+        // analysis: coupons fixing on or before that date use the historical
+        // fixing, read on the calling thread when the pricer is built, while
+        // later ones are forecast by the base pricer.
+        class HistoricalFixingCouponPricer : public QuantLib::BlackIborCouponPricer {
+          public:
+            HistoricalFixingCouponPricer(const QuantLib::Leg& leg,
+                                         const QuantLib::Date& evaluationDate)
+            : fixedCoupon_(0) {
+                for (QuantLib::Size i=0; i<leg.size(); ++i) {
+                    boost::shared_ptr<QuantLib::FloatingRateCoupon> coupon =
+                        boost::dynamic_pointer_cast<QuantLib::FloatingRateCoupon>(leg[i]);
+                    if (coupon && coupon->fixingDate() <= evaluationDate)
+                        fixings_[coupon->fixingDate()] =
+                            coupon->index()->timeSeries()[coupon->fixingDate()];
+                }
+            }
+            void initialize(const QuantLib::FloatingRateCoupon& coupon) {
+                QuantLib::BlackIborCouponPricer::initialize(coupon);
+                fixedCoupon_ = &coupon;
+            }
+            QuantLib::Rate swapletRate() const {
+                std::map<QuantLib::Date, QuantLib::Rate>::const_iterator fixing =
+                    fixings_.find(fixedCoupon_->fixingDate());
+                if (fixing == fixings_.end())
+                    return QuantLib::BlackIborCouponPricer::swapletRate();
+                QL_REQUIRE(fixing->second != QuantLib::Null<QuantLib::Rate>(),
+                           "Missing " << fixedCoupon_->index()->name() <<
+                           " fixing for " << fixing->first);
+                return fixedCoupon_->gearing() * fixing->second + fixedCoupon_->spread();
+            }
+          private:
+            std::map<QuantLib::Date, QuantLib::Rate> fixings_;
+            const QuantLib::FloatingRateCoupon* fixedCoupon_;
+        };
+
+        // The helpers and curve of one date of the analysis
+        struct ForwardRatesDate {
+            std::vector<boost::shared_ptr<QuantLib::RateHelper> > helpers;
+            boost::shared_ptr<QuantLib::YieldTermStructure> curve;
+            std::string error;
+        };
+
+        // Bootstraps the curves of a batch of dates and writes the forward
+        // rates of the i-th date into the i-th row of the matrix.
+        class ForwardRatesBatch {
+          public:
+            ForwardRatesBatch(std::vector<ForwardRatesDate>& batch,
+                              QuantLib::Size first,
+                              const std::vector<QuantLib::Date>& dates,
+                              const std::vector<QuantLib::Period>& fixingPeriods,
+                              const boost::shared_ptr<QuantLib::InterestRateIndex>& fwdIndex,
+                              QuantLib::Matrix& fwdRates)
+            : batch_(batch), first_(first), dates_(dates),
+              fixingPeriods_(fixingPeriods), indexTenor_(fwdIndex->tenor()),
+              indexDayCounter_(fwdIndex->dayCounter()), fwdRates_(fwdRates) {}
+            void operator()(QuantLib::Size k) {
+                ForwardRatesDate& date = batch_[k];
+                if (!date.curve)
+                    return;
+                QuantLib::Size i = first_ + k;
+                try {
+                    for (QuantLib::Size j=0; j<fixingPeriods_.size(); ++j)
+                        fwdRates_[i][j] = date.curve->forwardRate(
+                            dates_[i] + fixingPeriods_[j], indexTenor_,
+                            indexDayCounter_, QuantLib::Simple).rate();
+                } catch (std::exception& e) {
+                    date.error = e.what();
+                }
+            }
+          private:
+            std::vector<ForwardRatesDate>& batch_;
+            QuantLib::Size first_;
+            const std::vector<QuantLib::Date>& dates_;
+            const std::vector<QuantLib::Period>& fixingPeriods_;
+            QuantLib::Period indexTenor_;
+            QuantLib::DayCounter indexDayCounter_;
+            QuantLib::Matrix& fwdRates_;
+        };
+
+        // Same analysis as QuantLib::historicalForwardRatesAnalysis, with
+        // the curves of different dates bootstrapped concurrently.
+        //
+        // The evaluation date is global, so the helpers and curve of each
+        // date are built on the calling thread, with the helpers detached
+        // from the evaluation date and the curve given a fixed reference
+        // date.  During the concurrent bootstraps the evaluation date is
+        // left before the first date, so that no swap is expired and the
+        // deposits forecast their fixing as in the serial analysis; the
+        // swap coupons already fixed on the date of the analysis get their
+        // historical fixing from a HistoricalFixingCouponPricer.  Each curve
+        // is thus bootstrapped on the same inputs as in the serial analysis;
+        // the only difference is that the serial bootstrap starts from the
+        // curve of the previous date, so the two agree within the bootstrap
+        // accuracy.  Dates are processed in batches to bound memory, and the
+        // forward rate changes are added to the statistics in date order.
+        class ParallelHistoricalForwardRatesAnalysis
+            : public QuantLib::HistoricalForwardRatesAnalysis {
+          public:
+            ParallelHistoricalForwardRatesAnalysis(
+                const boost::shared_ptr<QuantLib::SequenceStatistics>& stats,
+                const QuantLib::Date& startDate,
+                const QuantLib::Date& endDate,
+                const QuantLib::Period& step,
+                const boost::shared_ptr<QuantLib::InterestRateIndex>& fwdIndex,
+                const QuantLib::Period& initialGap,
+                const QuantLib::Period& horizon,
+                const std::vector<boost::shared_ptr<QuantLib::IborIndex> >& iborIndexes,
+                const std::vector<boost::shared_ptr<QuantLib::SwapIndex> >& swapIndexes,
+                const QuantLib::DayCounter& yieldCurveDayCounter,
+                const std::string& traitsID,
+                const std::string& interpolatorID,
+                QuantLib::Real yieldCurveAccuracy,
+                QuantLib::Size threads);
+            const std::vector<QuantLib::Date>& skippedDates() const {
+                return skippedDates_;
+            }
+            const std::vector<std::string>& skippedDatesErrorMessage() const {
+                return skippedDatesErrorMessage_;
+            }
+            const std::vector<QuantLib::Date>& failedDates() const {
+                return failedDates_;
+            }
+            const std::vector<std::string>& failedDatesErrorMessage() const {
+                return failedDatesErrorMessage_;
+            }
+            const std::vector<QuantLib::Period>& fixingPeriods() const {
+                return fixingPeriods_;
+            }
+          private:
+            std::vector<QuantLib::Date> skippedDates_;
+            std::vector<std::string> skippedDatesErrorMessage_;
+            std::vector<QuantLib::Date> failedDates_;
+            std::vector<std::string> failedDatesErrorMessage_;
+            std::vector<QuantLib::Period> fixingPeriods_;
+        };
+
+        ParallelHistoricalForwardRatesAnalysis::ParallelHistoricalForwardRatesAnalysis(
+                const boost::shared_ptr<QuantLib::SequenceStatistics>& stats,
+                const QuantLib::Date& startDate,
+                const QuantLib::Date& endDate,
+                const QuantLib::Period& step,
+                const boost::shared_ptr<QuantLib::InterestRateIndex>& fwdIndex,
+                const QuantLib::Period& initialGap,
+                const QuantLib::Period& horizon,
+                const std::vector<boost::shared_ptr<QuantLib::IborIndex> >& iborIndexes,
+                const std::vector<boost::shared_ptr<QuantLib::SwapIndex> >& swapIndexes,
+                const QuantLib::DayCounter& yieldCurveDayCounter,
+                const std::string& traitsID,
+                const std::string& interpolatorID,
+                QuantLib::Real yieldCurveAccuracy,
+                QuantLib::Size threads) {
+
+            stats->reset();
+
+            QuantLib::Period indexTenor = fwdIndex->tenor();
+            QuantLib::Period fixingPeriod = initialGap;
+            while (fixingPeriod<=horizon) {
+                fixingPeriods_.push_back(fixingPeriod);
+                fixingPeriod += indexTenor;
+            }
+
+            QuantLib::Calendar cal = fwdIndex->fixingCalendar();
+            std::vector<QuantLib::Date> dates;
+            for (QuantLib::Date currentDate = cal.advance(startDate, 1*QuantLib::Days,
+                                                          QuantLib::Following);
+                 currentDate<=endDate;
+                 currentDate = cal.advance(currentDate, step, QuantLib::Following))
+                dates.push_back(currentDate);
+            if (dates.empty())
+                return;
+
+            QuantLib::Size n = fixingPeriods_.size();
+            QuantLib::Matrix fwdRates(dates.size(), n);
+            std::vector<bool> skipped(dates.size(), false), failed(dates.size(), false);
+            std::vector<std::string> errors(dates.size());
+
+            QuantLib::SavedSettings backup;
+            QuantLib::Settings::instance().enforcesTodaysHistoricFixings() = true;
+
+            QuantLib::Size batchSize = 16*workerThreads(threads);
+            for (QuantLib::Size first=0; first<dates.size(); first+=batchSize) {
+                QuantLib::Size last = std::min(first+batchSize, dates.size());
+                std::vector<ForwardRatesDate> batch(last-first);
+
+                for (QuantLib::Size i=first; i<last; ++i) {
+                    const QuantLib::Date& currentDate = dates[i];
+                    ForwardRatesDate& date = batch[i-first];
+                    QuantLib::Settings::instance().evaluationDate() = currentDate;
+                    try {
+                        for (QuantLib::Size k=0; k<iborIndexes.size(); ++k) {
+                            const boost::shared_ptr<QuantLib::IborIndex>& ibor = iborIndexes[k];
+                            QuantLib::Handle<QuantLib::Quote> quote(
+                                boost::shared_ptr<QuantLib::Quote>(new
+                                    QuantLib::SimpleQuote(ibor->fixing(currentDate, false))));
+                            date.helpers.push_back(boost::shared_ptr<QuantLib::RateHelper>(new
+                                QuantLib::DepositRateHelper(quote,
+                                                            ibor->tenor(),
+                                                            ibor->fixingDays(),
+                                                            ibor->fixingCalendar(),
+                                                            ibor->businessDayConvention(),
+                                                            ibor->endOfMonth(),
+                                                            ibor->dayCounter())));
+                        }
+                        for (QuantLib::Size k=0; k<swapIndexes.size(); ++k) {
+                            const boost::shared_ptr<QuantLib::SwapIndex>& swap = swapIndexes[k];
+                            QuantLib::Handle<QuantLib::Quote> quote(
+                                boost::shared_ptr<QuantLib::Quote>(new
+                                    QuantLib::SimpleQuote(swap->fixing(currentDate, false))));
+                            boost::shared_ptr<QuantLib::SwapRateHelper> helper(new
+                                QuantLib::SwapRateHelper(quote,
+                                                         swap->tenor(),
+                                                         swap->fixingCalendar(),
+                                                         swap->fixedLegTenor().frequency(),
+                                                         swap->fixedLegConvention(),
+                                                         swap->dayCounter(),
+                                                         swap->iborIndex()));
+                            const QuantLib::Leg& floatingLeg = helper->swap()->floatingLeg();
+                            QuantLib::setCouponPricer(floatingLeg,
+                                boost::shared_ptr<QuantLib::FloatingRateCouponPricer>(new
+                                    HistoricalFixingCouponPricer(floatingLeg, currentDate)));
+                            date.helpers.push_back(helper);
+                        }
+                    } catch (std::exception& e) {
+                        skipped[i] = true;
+                        errors[i] = e.what();
+                        date.helpers.clear();
+                        continue;
+                    }
+                    // the helpers would otherwise move their dates along
+                    // with the evaluation date
+                    for (QuantLib::Size k=0; k<date.helpers.size(); ++k)
+                        date.helpers[k]->unregisterWithAll();
+                    date.curve = fixedReferenceDateCurve(traitsID, interpolatorID,
+                                                         currentDate, date.helpers,
+                                                         yieldCurveDayCounter,
+                                                         yieldCurveAccuracy);
+                }
+
+                QuantLib::Settings::instance().evaluationDate() = dates.front() - 1;
+                ForwardRatesBatch f(batch, first, dates, fixingPeriods_, fwdIndex, fwdRates);
+                parallelFor(batch.size(), threads, f);
+
+                for (QuantLib::Size i=first; i<last; ++i) {
+                    if (!batch[i-first].error.empty()) {
+                        failed[i] = true;
+                        errors[i] = batch[i-first].error;
+                    }
+                }
+                // the batch holds objects registered with global
+                // observables and is destroyed here, on the calling thread
+            }
+
+            std::vector<QuantLib::Real> fwdRatesDiff(n);
+            bool isFirst = true;
+            QuantLib::Size previous = 0;
+            for (QuantLib::Size i=0; i<dates.size(); ++i) {
+                if (skipped[i]) {
+                    skippedDates_.push_back(dates[i]);
+                    skippedDatesErrorMessage_.push_back(errors[i]);
+                } else if (failed[i]) {
+                    failedDates_.push_back(dates[i]);
+                    failedDatesErrorMessage_.push_back(errors[i]);
+                } else {
+                    if (!isFirst) {
+                        for (QuantLib::Size j=0; j<n; ++j)
+                            fwdRatesDiff[j] = fwdRates[i][j]/fwdRates[previous][j] - 1.0;
+                        stats->add(fwdRatesDiff.begin(), fwdRatesDiff.end());
+                    } else {
+                        isFirst = false;
+                    }
+                    previous = i;
+                }
+            }
+        }
+
+    }
+
     HistoricalForwardRatesAnalysis::HistoricalForwardRatesAnalysis(
         const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
         const boost::shared_ptr<QuantLib::SequenceStatistics>& stats,
@@ -111,8 +403,27 @@ namespace QuantLibAddin {
         const std::string& traitsID, 
         const std::string& interpolatorID,
         QuantLib::Real yieldCurveAccuracy,
+        QuantLib::Size threads,
         bool permanent) : ObjectHandler::LibraryObject<QuantLib::HistoricalForwardRatesAnalysis>(properties, permanent)
     {
+        if (threads != 1) {
+            libraryObject_ = boost::shared_ptr<QuantLib::HistoricalForwardRatesAnalysis>(new
+                ParallelHistoricalForwardRatesAnalysis(stats,
+                                                       startDate,
+                                                       endDate,
+                                                       step,
+                                                       fwdIndex,
+                                                       initialGap,
+                                                       horizon,
+                                                       iborInd,
+                                                       swapInd,
+                                                       yieldCurveDayCounter,
+                                                       traitsID,
+                                                       interpolatorID,
+                                                       yieldCurveAccuracy,
+                                                       threads));
+            return;
+        }
         libraryObject_ = ObjectHandler::Create<boost::shared_ptr<
             QuantLib::HistoricalForwardRatesAnalysis> >()(traitsID,
                                               interpolatorID,
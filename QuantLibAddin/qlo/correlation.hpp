@@ -130,6 +130,7 @@ namespace QuantLibAddin {
                 const std::string& traitsID, 
                 const std::string& interpolatorID,
                 QuantLib::Real yieldCurveAccuracy,
+                QuantLib::Size threads,
                 bool permanent);
     };
 
@@ -20,6 +20,8 @@
 
 #include <qlo/qladdindefines.hpp>
 #include <qlo/credit.hpp>
+#include <qlo/defaultcurvecache.hpp>
+#include <qlo/incrementalbootstrap.hpp>
 #include <qlo/enumerations/factories/termstructuresfactory.hpp>
 
 #include <ql/instruments/stock.hpp>
@@ -52,6 +54,7 @@ namespace QuantLibAddin {
             const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
             const boost::shared_ptr<QuantLib::DefaultProbabilityTermStructure>& dfts,
             const boost::shared_ptr<QuantLib::DefaultEventSet>& evtSet,
+            bool cacheSurvivalProbabilities,
             bool permanent
         )
         : ObjectHandler::LibraryObject<QuantLib::Issuer>(properties, permanent) {
@@ -62,7 +65,9 @@ namespace QuantLibAddin {
                                                      QuantLib::Period(),
                                                      1. // amount threshold
                                                      ),
-            QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure>(dfts)
+            cacheSurvivalProbabilities ?
+                cachedDefaultCurve(dfts) :
+                QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure>(dfts)
         ));
         libraryObject_ = boost::shared_ptr<QuantLib::Issuer>(new QuantLib::Issuer(curves, *evtSet));
     }
@@ -164,10 +169,14 @@ namespace QuantLibAddin {
             const QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure>& defaultTS,
             QuantLib::Real recoveryRate,
             const QuantLib::Handle<QuantLib::YieldTermStructure>& yieldTS,
+            bool cacheSurvivalProbabilities,
             bool permanent) 
         : PricingEngine(properties, permanent) {
         libraryObject_ = boost::shared_ptr<QuantLib::PricingEngine>(new
-              QuantLib::MidPointCdsEngine(defaultTS, recoveryRate, yieldTS));
+              QuantLib::MidPointCdsEngine(cacheSurvivalProbabilities ?
+                                              cachedDefaultCurve(defaultTS) :
+                                              defaultTS,
+                                          recoveryRate, yieldTS));
     }
 
 
@@ -259,10 +268,34 @@ namespace QuantLibAddin {
             const QuantLib::Calendar& calendar,
             const std::string& interpolator,
             QuantLib::Real accuracy,
+            bool incremental,
             bool permanent) 
         : DefaultProbabilityTermStructure(properties, permanent) {
 
-        if(interpolator == std::string("LINEAR")){
+        if(incremental) {
+            typedef QuantLib::PiecewiseDefaultCurve<QuantLib::HazardRate,
+                QuantLib::Linear, IncrementalBootstrap> lin_curve;
+            typedef QuantLib::PiecewiseDefaultCurve<QuantLib::HazardRate,
+                QuantLib::BackwardFlat, IncrementalBootstrap> flat_curve;
+            statistics_ = boost::make_shared<BootstrapStatistics>();
+            if(interpolator == std::string("LINEAR")){
+                libraryObject_ = boost::shared_ptr<QuantLib::Extrapolator>(new
+                    lin_curve(0, calendar, helpers, dayCounter,
+                              std::vector<QuantLib::Handle<QuantLib::Quote> >(),
+                              std::vector<QuantLib::Date>(),
+                              QuantLib::Linear(),
+                              IncrementalBootstrap<lin_curve>(statistics_, accuracy)));
+            }else if(interpolator == std::string("BACKWARDFLAT")) {
+                libraryObject_ = boost::shared_ptr<QuantLib::Extrapolator>(new
+                    flat_curve(0, calendar, helpers, dayCounter,
+                               std::vector<QuantLib::Handle<QuantLib::Quote> >(),
+                               std::vector<QuantLib::Date>(),
+                               QuantLib::BackwardFlat(),
+                               IncrementalBootstrap<flat_curve>(statistics_, accuracy)));
+            }else{
+                QL_FAIL("Unrecognised interpolator");
+            }
+        }else if(interpolator == std::string("LINEAR")){
             libraryObject_ = boost::shared_ptr<QuantLib::Extrapolator>(new
                    QuantLib::PiecewiseDefaultCurve<QuantLib::HazardRate,
                         QuantLib::Linear>(
@@ -290,27 +323,52 @@ namespace QuantLibAddin {
     const std::vector<QuantLib::Date>& PiecewiseHazardRateCurve::dates() const {
         typedef QuantLib::PiecewiseDefaultCurve<QuantLib::HazardRate, QuantLib::BackwardFlat> flat_curve;
         typedef QuantLib::PiecewiseDefaultCurve<QuantLib::HazardRate, QuantLib::Linear> lin_curve;
+        typedef QuantLib::PiecewiseDefaultCurve<QuantLib::HazardRate, QuantLib::BackwardFlat, IncrementalBootstrap> inc_flat_curve;
+        typedef QuantLib::PiecewiseDefaultCurve<QuantLib::HazardRate, QuantLib::Linear, IncrementalBootstrap> inc_lin_curve;
         boost::shared_ptr<flat_curve> ptrBF =
             boost::dynamic_pointer_cast<flat_curve>(libraryObject_);
         if(ptrBF) return ptrBF->dates();
         boost::shared_ptr<lin_curve> ptrLIN =
             boost::dynamic_pointer_cast<lin_curve>(libraryObject_);
         if(ptrLIN) return ptrLIN->dates();
+        boost::shared_ptr<inc_flat_curve> ptrIncBF =
+            boost::dynamic_pointer_cast<inc_flat_curve>(libraryObject_);
+        if(ptrIncBF) return ptrIncBF->dates();
+        boost::shared_ptr<inc_lin_curve> ptrIncLIN =
+            boost::dynamic_pointer_cast<inc_lin_curve>(libraryObject_);
+        if(ptrIncLIN) return ptrIncLIN->dates();
         QL_FAIL("Unable to cast default probability term structure.");
     }
 
     const std::vector<QuantLib::Real>& PiecewiseHazardRateCurve::data() const {
         typedef QuantLib::PiecewiseDefaultCurve<QuantLib::HazardRate, QuantLib::BackwardFlat> flat_curve;
         typedef QuantLib::PiecewiseDefaultCurve<QuantLib::HazardRate, QuantLib::Linear> lin_curve;
+        typedef QuantLib::PiecewiseDefaultCurve<QuantLib::HazardRate, QuantLib::BackwardFlat, IncrementalBootstrap> inc_flat_curve;
+        typedef QuantLib::PiecewiseDefaultCurve<QuantLib::HazardRate, QuantLib::Linear, IncrementalBootstrap> inc_lin_curve;
         boost::shared_ptr<flat_curve> ptrBF =
             boost::dynamic_pointer_cast<flat_curve>(libraryObject_);
         if(ptrBF) return ptrBF->data();
         boost::shared_ptr<lin_curve> ptrLIN =
             boost::dynamic_pointer_cast<lin_curve>(libraryObject_);
         if(ptrLIN) return ptrLIN->data();
+        boost::shared_ptr<inc_flat_curve> ptrIncBF =
+            boost::dynamic_pointer_cast<inc_flat_curve>(libraryObject_);
+        if(ptrIncBF) return ptrIncBF->data();
+        boost::shared_ptr<inc_lin_curve> ptrIncLIN =
+            boost::dynamic_pointer_cast<inc_lin_curve>(libraryObject_);
+        if(ptrIncLIN) return ptrIncLIN->data();
         QL_FAIL("Unable to cast default probability term structure.");
         }        
 
+    std::vector<std::vector<ObjectHandler::property_t> >
+    PiecewiseHazardRateCurve::bootstrapStatistics() const {
+        QL_REQUIRE(statistics_,
+                   "curve not built with an incremental bootstrap");
+        // make sure that a pending bootstrap is run
+        data();
+        return QuantLibAddin::bootstrapStatistics(*statistics_);
+    }
+
 
     PiecewiseFlatForwardCurve::PiecewiseFlatForwardCurve(
             const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
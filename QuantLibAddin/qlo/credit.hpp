@@ -59,6 +59,7 @@ namespace QuantLibAddin {
             const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
             const boost::shared_ptr<QuantLib::DefaultProbabilityTermStructure>& dfts,
             const boost::shared_ptr<QuantLib::DefaultEventSet>& evtSet,
+            bool cacheSurvivalProbabilities,
             bool permanent
             );
     };
@@ -115,6 +116,7 @@ namespace QuantLibAddin {
             const QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure>&,
             QuantLib::Real recoveryRate,
             const QuantLib::Handle<QuantLib::YieldTermStructure>&,
+            bool cacheSurvivalProbabilities,
             bool permanent);
     };
 
@@ -192,10 +194,13 @@ namespace QuantLibAddin {
             const QuantLib::Calendar& calendar,
             const std::string& interpolator,
             QuantLib::Real accuracy,
+            bool incremental,
             bool permanent);
 
         const std::vector<QuantLib::Date>& dates() const;
         const std::vector<QuantLib::Real>& data() const;
+        // only available for curves built with an incremental bootstrap
+        std::vector<std::vector<ObjectHandler::property_t> > bootstrapStatistics() const;
         /*
         const std::vector<QuantLib::Time>& times() const;
         const std::vector<QuantLib::Date>& dates() const;
@@ -217,6 +222,8 @@ namespace QuantLibAddin {
              InterpolatedYieldCurve::Traits traits,
              InterpolatedYieldCurve::Interpolator interpolator) const;
         */
+      private:
+        boost::shared_ptr<BootstrapStatistics> statistics_;
     };
 
     // no jump dates and jumps, traits = Discount, interpolator = LogLinear
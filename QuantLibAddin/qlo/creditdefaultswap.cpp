@@ -19,8 +19,12 @@
 */
 
 #include <qlo/creditdefaultswap.hpp>
+#include <qlo/defaultcurvecache.hpp>
+#include <oh/repository.hpp>
 
 #include <ql/instruments/creditdefaultswap.hpp>
+#include <ql/pricingengines/credit/midpointcdsengine.hpp>
+#include <ql/utilities/null.hpp>
 
 namespace QuantLibAddin {
 
@@ -70,5 +74,85 @@ namespace QuantLibAddin {
                         boost::shared_ptr<QuantLib::Claim>()));
             }
     }
-    
+
+    std::vector<std::vector<ObjectHandler::property_t> > cdsNPVBatch(
+        const std::vector<std::string>& cdsIds,
+        const QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure>& defaultCurve,
+        QuantLib::Real recoveryRate,
+        const QuantLib::Handle<QuantLib::YieldTermStructure>& yieldCurve) {
+
+        QL_REQUIRE(!cdsIds.empty(), "no CDS given");
+
+        QuantLib::Size n = cdsIds.size();
+        std::vector<boost::shared_ptr<QuantLib::CreditDefaultSwap> > cds(n);
+        std::vector<std::string> errors(n);
+        for (QuantLib::Size i=0; i<n; ++i) {
+            try {
+                boost::shared_ptr<ObjectHandler::LibraryObject<QuantLib::Instrument> > object;
+                ObjectHandler::Repository::instance().retrieveObject(object, cdsIds[i]);
+                object->getLibraryObject(cds[i]);
+            } catch (std::exception& e) {
+                errors[i] = e.what();
+            }
+        }
+
+        // the contracts share the survival probabilities at their common
+        // dates through the cached curve
+        QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure> curve =
+            cachedDefaultCurve(defaultCurve);
+        QuantLib::MidPointCdsEngine engine(curve, recoveryRate, yieldCurve);
+        QuantLib::CreditDefaultSwap::arguments* arguments =
+            dynamic_cast<QuantLib::CreditDefaultSwap::arguments*>(engine.getArguments());
+        const QuantLib::CreditDefaultSwap::results* results =
+            dynamic_cast<const QuantLib::CreditDefaultSwap::results*>(engine.getResults());
+        QL_REQUIRE(arguments && results, "wrong engine type");
+
+        std::vector<std::vector<ObjectHandler::property_t> > result;
+        std::vector<ObjectHandler::property_t> headings;
+        headings.push_back(std::string("CDS"));
+        headings.push_back(std::string("NPV"));
+        headings.push_back(std::string("FairSpread"));
+        headings.push_back(std::string("CouponLegNPV"));
+        headings.push_back(std::string("DefaultLegNPV"));
+        headings.push_back(std::string("Error"));
+        result.push_back(headings);
+
+        for (QuantLib::Size i=0; i<n; ++i) {
+            QuantLib::Real values[4] = {
+                QuantLib::Null<QuantLib::Real>(), QuantLib::Null<QuantLib::Real>(),
+                QuantLib::Null<QuantLib::Real>(), QuantLib::Null<QuantLib::Real>()
+            };
+            if (cds[i]) {
+                try {
+                    if (cds[i]->isExpired()) {
+                        values[0] = 0.0;
+                    } else {
+                        engine.reset();
+                        cds[i]->setupArguments(arguments);
+                        arguments->validate();
+                        engine.calculate();
+                        values[0] = results->value;
+                        values[1] = results->fairSpread;
+                        values[2] = results->couponLegNPV;
+                        values[3] = results->defaultLegNPV;
+                    }
+                } catch (std::exception& e) {
+                    errors[i] = e.what();
+                }
+            }
+            std::vector<ObjectHandler::property_t> row;
+            row.reserve(headings.size());
+            row.push_back(cdsIds[i]);
+            for (QuantLib::Size j=0; j<4; ++j) {
+                if (values[j] != QuantLib::Null<QuantLib::Real>())
+                    row.push_back(values[j]);
+                else
+                    row.push_back(std::string("#N/A"));
+            }
+            row.push_back(errors[i]);
+            result.push_back(row);
+        }
+        return result;
+    }
+
 }
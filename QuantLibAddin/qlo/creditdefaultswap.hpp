@@ -25,12 +25,15 @@
 
 #include <ql/types.hpp>
 #include <ql/default.hpp>
+#include <ql/handle.hpp>
 #include <ql/time/schedule.hpp>
 #include <ql/time/businessdayconvention.hpp>
 #include <ql/time/daycounter.hpp>
 
 namespace QuantLib {
     class Date;
+    class DefaultProbabilityTermStructure;
+    class YieldTermStructure;
 }
 
 namespace QuantLibAddin {
@@ -53,6 +56,18 @@ namespace QuantLibAddin {
             bool permanent);
     };
 
+    // Prices the given CDS with a midpoint engine on one issuer curve and
+    // returns their NPV, fair spread and leg NPVs, one row per CDS.  The
+    // engine reads the curve through cachedDefaultCurve(), so that the
+    // survival probability at each date shared by several contracts is
+    // computed once; the CDS objects and their own pricing engines are
+    // left untouched.
+    std::vector<std::vector<ObjectHandler::property_t> > cdsNPVBatch(
+        const std::vector<std::string>& cdsIds,
+        const QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure>& defaultCurve,
+        QuantLib::Real recoveryRate,
+        const QuantLib::Handle<QuantLib::YieldTermStructure>& yieldCurve);
+
 }
 
 #endif
@@ -25,6 +25,8 @@
     #include <qlo/config.hpp>
 #endif
 #include <qlo/ctsmmcapletcalibration.hpp>
+#include <qlo/parallel.hpp>
+#include <oh/conversions/convert2.hpp>
 #include <ql/models/marketmodels/models/alphaform.hpp>
 #include <ql/models/marketmodels/models/capletcoterminalswaptioncalibration.hpp>
 #include <ql/models/marketmodels/models/capletcoterminalalphacalibration.hpp>
@@ -93,5 +95,147 @@ namespace QuantLibAddin {
                     displacement, caplet0Swaption1Priority));
     }
 
-}
+    namespace {
+
+        struct CTSMMCalibrationRun {
+            CTSMMCalibrationRun() : converged(false), elapsed(0.0) {}
+            bool converged;
+            std::string error;
+            QuantLib::Real elapsed;
+        };
+
+        // Calibrates the objects of one group, i.e. sharing a curve state
+        // or alpha form, in turn.
+        class CTSMMGroupCalibration {
+          public:
+            CTSMMGroupCalibration(
+                const std::vector<boost::shared_ptr<QuantLib::CTSMMCapletCalibration> >& calibrations,
+                const std::vector<std::vector<QuantLib::Size> >& groups,
+                QuantLib::Natural numberOfFactors,
+                QuantLib::Natural maxIterations,
+                QuantLib::Real capletVolTolerance,
+                QuantLib::Natural innerMaxIterations,
+                QuantLib::Real innerTolerance,
+                std::vector<CTSMMCalibrationRun>& runs)
+            : calibrations_(calibrations), groups_(groups),
+              numberOfFactors_(numberOfFactors), maxIterations_(maxIterations),
+              capletVolTolerance_(capletVolTolerance),
+              innerMaxIterations_(innerMaxIterations),
+              innerTolerance_(innerTolerance), runs_(runs) {}
+            void operator()(QuantLib::Size g) {
+                for (QuantLib::Size k=0; k<groups_[g].size(); ++k) {
+                    QuantLib::Size i = groups_[g][k];
+                    WallTimer timer;
+                    try {
+                        runs_[i].converged = calibrations_[i]->calibrate(
+                            numberOfFactors_, maxIterations_,
+                            capletVolTolerance_, innerMaxIterations_,
+                            innerTolerance_);
+                    } catch (std::exception& e) {
+                        runs_[i].error = e.what();
+                    }
+                    runs_[i].elapsed = timer.elapsed();
+                }
+            }
+          private:
+            const std::vector<boost::shared_ptr<QuantLib::CTSMMCapletCalibration> >& calibrations_;
+            const std::vector<std::vector<QuantLib::Size> >& groups_;
+            QuantLib::Natural numberOfFactors_, maxIterations_;
+            QuantLib::Real capletVolTolerance_;
+            QuantLib::Natural innerMaxIterations_;
+            QuantLib::Real innerTolerance_;
+            std::vector<CTSMMCalibrationRun>& runs_;
+        };
+
+        std::string propertyId(const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+                               const std::string& name) {
+            std::set<std::string> names = properties->getPropertyNames();
+            if (names.find(name) == names.end())
+                return std::string();
+            return ObjectHandler::convert2<std::string>(
+                properties->getProperty(name), name);
+        }
+
+    }
+
+    std::vector<std::vector<ObjectHandler::property_t> > calibrateCTSMMMultiStart(
+        const std::vector<boost::shared_ptr<CTSMMCapletCalibration> >& calibrationObjects,
+        QuantLib::Natural numberOfFactors,
+        QuantLib::Natural maxIterations,
+        QuantLib::Real capletVolTolerance,
+        QuantLib::Natural innerMaxIterations,
+        QuantLib::Real innerTolerance,
+        QuantLib::Size threads) {
 
+        QL_REQUIRE(!calibrationObjects.empty(), "no calibrations given");
+
+        // CurveState accessors and AlphaForm::setAlpha update shared state:
+        // objects built on the same ones are calibrated in turn
+        QuantLib::Size n = calibrationObjects.size();
+        std::vector<boost::shared_ptr<QuantLib::CTSMMCapletCalibration> >
+            calibrations(n);
+        std::vector<std::vector<std::string> > shared(n);
+        for (QuantLib::Size i=0; i<n; ++i) {
+            calibrationObjects[i]->getLibraryObject(calibrations[i]);
+            boost::shared_ptr<ObjectHandler::ValueObject> properties =
+                calibrationObjects[i]->properties();
+            shared[i].push_back(propertyId(properties, "CurveState"));
+            shared[i].push_back(propertyId(properties, "AlphaForm"));
+        }
+        std::vector<std::vector<QuantLib::Size> > groups =
+            groupBySharedKeys(shared);
+
+        std::vector<CTSMMCalibrationRun> runs(n);
+        CTSMMGroupCalibration f(calibrations, groups, numberOfFactors,
+                                maxIterations, capletVolTolerance,
+                                innerMaxIterations, innerTolerance, runs);
+        parallelFor(groups.size(), threads, f);
+
+        std::vector<std::vector<ObjectHandler::property_t> > result;
+        QuantLib::Size numberOfColumns = 11;
+        std::vector<ObjectHandler::property_t> headings(numberOfColumns);
+        headings[0] = std::string("Start");
+        headings[1] = std::string("Converged");
+        headings[2] = std::string("Failures");
+        headings[3] = std::string("Deformation Size");
+        headings[4] = std::string("Caplet RMS Error");
+        headings[5] = std::string("Caplet Max Error");
+        headings[6] = std::string("Swaption RMS Error");
+        headings[7] = std::string("Swaption Max Error");
+        headings[8] = std::string("Elapsed");
+        headings[9] = std::string("Error");
+        headings[10] = std::string("Best");
+        result.push_back(headings);
+
+        QuantLib::Size best = n;
+        QuantLib::Real bestError = QuantLib::QL_MAX_REAL;
+        for (QuantLib::Size i=0; i<n; ++i) {
+            std::vector<ObjectHandler::property_t> row(numberOfColumns,
+                                                       std::string("N/A"));
+            row[0] = static_cast<long>(i);
+            row[1] = runs[i].converged;
+            row[8] = runs[i].elapsed;
+            row[10] = false;
+            if (runs[i].error.empty()) {
+                row[2] = static_cast<long>(calibrations[i]->failures());
+                row[3] = calibrations[i]->deformationSize();
+                row[4] = calibrations[i]->capletRmsError();
+                row[5] = calibrations[i]->capletMaxError();
+                row[6] = calibrations[i]->swaptionRmsError();
+                row[7] = calibrations[i]->swaptionMaxError();
+                if (runs[i].converged &&
+                    calibrations[i]->capletRmsError() < bestError) {
+                    bestError = calibrations[i]->capletRmsError();
+                    best = i;
+                }
+            } else {
+                row[9] = runs[i].error;
+            }
+            result.push_back(row);
+        }
+        if (best != n)
+            result[best+1][10] = true;
+        return result;
+    }
+
+}
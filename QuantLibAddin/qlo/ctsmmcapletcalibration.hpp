@@ -25,6 +25,7 @@
 #define qla_ctsmmcapletcalibration_hpp
 
 #include <oh/libraryobject.hpp>
+#include <oh/property.hpp>
 
 #include <ql/types.hpp>
 
@@ -89,6 +90,24 @@ namespace QuantLibAddin {
             bool permanent);
     };
 
+    //! Calibrate alternative set-ups of the same caplet calibration problem.
+    /*! Each calibration object is typically built from a different initial
+        guess (e.g. alpha) of the same market data.  All are calibrated with
+        the given settings on up to the given number of threads (0 meaning
+        one per hardware thread), and one row of diagnostics is returned per
+        object, flagging the converged one with the lowest caplet RMS error.
+        Objects sharing a CurveState or an AlphaForm are calibrated in turn
+        on one thread: CurveState accessors update cached values and
+        AlphaForm keeps the alpha being calibrated.
+    */
+    std::vector<std::vector<ObjectHandler::property_t> > calibrateCTSMMMultiStart(
+        const std::vector<boost::shared_ptr<CTSMMCapletCalibration> >& calibrations,
+        QuantLib::Natural numberOfFactors,
+        QuantLib::Natural maxIterations,
+        QuantLib::Real capletVolTolerance,
+        QuantLib::Natural innerMaxIterations,
+        QuantLib::Real innerTolerance,
+        QuantLib::Size threads);
 
  }
 
@@ -0,0 +1,170 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <qlo/config.hpp>
+#endif
+#include <qlo/defaultcurvecache.hpp>
+
+#include <boost/weak_ptr.hpp>
+
+#include <map>
+
+namespace QuantLibAddin {
+
+    CachedDefaultCurve::CachedDefaultCurve(
+        const QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure>& curve)
+    : curve_(curve) {
+        registerWith(curve_);
+        enableExtrapolation();
+    }
+
+    QuantLib::DayCounter CachedDefaultCurve::dayCounter() const {
+        return curve_->dayCounter();
+    }
+
+    QuantLib::Calendar CachedDefaultCurve::calendar() const {
+        return curve_->calendar();
+    }
+
+    QuantLib::Natural CachedDefaultCurve::settlementDays() const {
+        return curve_->settlementDays();
+    }
+
+    const QuantLib::Date& CachedDefaultCurve::referenceDate() const {
+        return curve_->referenceDate();
+    }
+
+    QuantLib::Date CachedDefaultCurve::maxDate() const {
+        return curve_->maxDate();
+    }
+
+    QuantLib::Time CachedDefaultCurve::maxTime() const {
+        return curve_->maxTime();
+    }
+
+    void CachedDefaultCurve::update() {
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            probabilities_.clear();
+        }
+        QuantLib::DefaultProbabilityTermStructure::update();
+    }
+
+    QuantLib::Size CachedDefaultCurve::cached() const {
+        boost::mutex::scoped_lock lock(mutex_);
+        return probabilities_.size();
+    }
+
+    QuantLib::Probability CachedDefaultCurve::survivalProbabilityImpl(
+                                                    QuantLib::Time t) const {
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            boost::unordered_map<QuantLib::Time, QuantLib::Probability>::const_iterator
+                i = probabilities_.find(t);
+            if (i != probabilities_.end())
+                return i->second;
+        }
+        // evaluated outside the lock, since the underlying curve might
+        // bootstrap itself first
+        QuantLib::Probability p = curve_->survivalProbability(t);
+        boost::mutex::scoped_lock lock(mutex_);
+        probabilities_[t] = p;
+        return p;
+    }
+
+    QuantLib::Real CachedDefaultCurve::defaultDensityImpl(QuantLib::Time t) const {
+        return curve_->defaultDensity(t);
+    }
+
+    namespace {
+
+        typedef QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure> CurveHandle;
+
+        // Curves are only shared while some engine or issuer holds them.
+        // Entries are keyed by the address of the handle link or curve,
+        // which the cached curve itself keeps alive: the map holds no
+        // reference, so that deleting the last object using a curve frees
+        // it, and expired entries are dropped whenever a curve is added.
+        class CachedCurves {
+          public:
+            static CachedCurves& instance() {
+                static CachedCurves curves;
+                return curves;
+            }
+            CurveHandle curve(const CurveHandle& h) {
+                // copies of a handle share its link, which is also the
+                // observable they notify through
+                boost::shared_ptr<QuantLib::Observable> link = h;
+                boost::mutex::scoped_lock lock(mutex_);
+                Curves::iterator i = byHandle_.find(link.get());
+                if (i != byHandle_.end()) {
+                    boost::shared_ptr<CachedDefaultCurve> cached = i->second.lock();
+                    if (cached)
+                        return CurveHandle(cached);
+                }
+                purge(byHandle_);
+                boost::shared_ptr<CachedDefaultCurve> cached(new CachedDefaultCurve(h));
+                byHandle_[link.get()] = cached;
+                return CurveHandle(cached);
+            }
+            CurveHandle curve(
+                const boost::shared_ptr<QuantLib::DefaultProbabilityTermStructure>& c) {
+                boost::mutex::scoped_lock lock(mutex_);
+                Curves::iterator i = byCurve_.find(c.get());
+                if (i != byCurve_.end()) {
+                    boost::shared_ptr<CachedDefaultCurve> cached = i->second.lock();
+                    if (cached)
+                        return CurveHandle(cached);
+                }
+                purge(byCurve_);
+                boost::shared_ptr<CachedDefaultCurve> cached(
+                                          new CachedDefaultCurve(CurveHandle(c)));
+                byCurve_[c.get()] = cached;
+                return CurveHandle(cached);
+            }
+          private:
+            CachedCurves() {}
+            typedef std::map<const void*, boost::weak_ptr<CachedDefaultCurve> > Curves;
+            static void purge(Curves& curves) {
+                Curves::iterator i = curves.begin();
+                while (i != curves.end()) {
+                    if (i->second.expired())
+                        curves.erase(i++);
+                    else
+                        ++i;
+                }
+            }
+            boost::mutex mutex_;
+            Curves byHandle_, byCurve_;
+        };
+
+    }
+
+    QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure> cachedDefaultCurve(
+        const QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure>& curve) {
+        return CachedCurves::instance().curve(curve);
+    }
+
+    QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure> cachedDefaultCurve(
+        const boost::shared_ptr<QuantLib::DefaultProbabilityTermStructure>& curve) {
+        if (boost::dynamic_pointer_cast<CachedDefaultCurve>(curve))
+            return QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure>(curve);
+        return CachedCurves::instance().curve(curve);
+    }
+
+}
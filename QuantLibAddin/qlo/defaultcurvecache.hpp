@@ -0,0 +1,82 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Default probability curves caching survival probabilities
+*/
+
+#ifndef qla_defaultcurvecache_hpp
+#define qla_defaultcurvecache_hpp
+
+#include <ql/handle.hpp>
+#include <ql/termstructures/defaulttermstructure.hpp>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace QuantLibAddin {
+
+    //! Survival probabilities of another curve, cached by time.
+    /*! Credit engines pricing many contracts on the same issuer ask the
+        curve for the survival probability at the same coupon dates over
+        and over; each distinct date is evaluated once here.  The cache is
+        emptied whenever the underlying curve, or the handle linking it,
+        notifies a change.  Range checks are left to the underlying curve.
+    */
+    class CachedDefaultCurve : public QuantLib::DefaultProbabilityTermStructure {
+      public:
+        explicit CachedDefaultCurve(
+            const QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure>& curve);
+        //! \name TermStructure interface
+        //@{
+        QuantLib::DayCounter dayCounter() const;
+        QuantLib::Calendar calendar() const;
+        QuantLib::Natural settlementDays() const;
+        const QuantLib::Date& referenceDate() const;
+        QuantLib::Date maxDate() const;
+        QuantLib::Time maxTime() const;
+        //@}
+        //! \name Observer interface
+        //@{
+        void update();
+        //@}
+        //! number of survival probabilities currently cached
+        QuantLib::Size cached() const;
+      protected:
+        QuantLib::Probability survivalProbabilityImpl(QuantLib::Time t) const;
+        QuantLib::Real defaultDensityImpl(QuantLib::Time t) const;
+      private:
+        QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure> curve_;
+        mutable boost::mutex mutex_;
+        mutable boost::unordered_map<QuantLib::Time, QuantLib::Probability> probabilities_;
+    };
+
+    //! Cached version of the curve linked to the given handle.
+    /*! Callers passing copies of the same handle share a single cache,
+        which follows the handle when it is relinked.  The cache is only
+        held by its callers and is freed with the last of them.
+    */
+    QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure> cachedDefaultCurve(
+        const QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure>& curve);
+
+    //! Cached version of the given curve, shared by all callers passing it.
+    QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure> cachedDefaultCurve(
+        const boost::shared_ptr<QuantLib::DefaultProbabilityTermStructure>& curve);
+
+}
+
+#endif
@@ -20,6 +20,7 @@
 #include <oh/ohdefines.hpp>
 #include <boost/regex.hpp>
 #include <qlo/enumerations/factories/calendarfactory.hpp>
+#include <qlo/calendarcache.hpp>
 #include <set>
 
 namespace ObjectHandler {
@@ -31,10 +32,18 @@ namespace ObjectHandler {
     }
     /*
     Calendar factory - accept a string, and return either a
-    QuantLib::Calendar or a QuantLib::JointCalendar as appropriate
+    QuantLib::Calendar or a QuantLib::JointCalendar as appropriate,
+    wrapped in a QuantLibAddin::CachedCalendar.  Calendars are cached
+    under the given ID, so that only the first request for a given ID
+    goes through the parsing and registry lookups below.
     */
 
     QuantLib::Calendar Create<QuantLib::Calendar>::operator()(const std::string &id) {
+        QuantLib::Calendar calendar;
+        QuantLibAddin::CalendarCache& cache = QuantLibAddin::CalendarCache::instance();
+        if (cache.find(id, calendar))
+            return calendar;
+
         idOriginal = id;
         // Is this an ID for a Calendar or a JointCalendar?
         if (testID()) {
@@ -43,16 +52,18 @@ namespace ObjectHandler {
             // Does the requested JointCalendar already exist?
             if (checkType(idFull)) {
                 // It does - return it.
-                return *(static_cast<QuantLib::Calendar*>(this->getType(idFull)));
+                calendar = *(static_cast<QuantLib::Calendar*>(this->getType(idFull)));
             } else {
                 // It doesn't - create it, add it to the registry, and return it.
                 QuantLib::Calendar *jointCalendar = makeJointCalendar(calendarIDs.size());
                 registerType(idFull, jointCalendar);
-                return *jointCalendar;
+                calendar = *jointCalendar;
             }
+            return cache.insert(id, idFull, calendar);
         } else {
             // the ID is for a Calendar - return it
-            return *(static_cast<QuantLib::Calendar*>(this->getType(id)));
+            calendar = *(static_cast<QuantLib::Calendar*>(this->getType(id)));
+            return cache.insert(id, idUpper, calendar);
         }
     }
 
@@ -92,6 +103,7 @@ namespace ObjectHandler {
 
         // Add the calendar IDs to a set where they will be uniquely sorted.
         std::set<std::string> calendarIdSet;
+        calendarIDs.clear();
 
         // Given that the regex succeeded, we're guaranteed :-) to have
         // m[1] - "JOINHOLIDAYS"/"JOINBUSINESSDAYS"
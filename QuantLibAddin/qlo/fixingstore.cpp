@@ -0,0 +1,227 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <qlo/config.hpp>
+#endif
+#include <qlo/fixingstore.hpp>
+
+#include <ql/index.hpp>
+#include <ql/math/comparison.hpp>
+#include <ql/timeseries.hpp>
+#include <ql/utilities/null.hpp>
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace QuantLibAddin {
+
+    namespace {
+
+        // File layout: header, index name padded to a multiple of eight
+        // bytes, then the date serial numbers and the values as two
+        // contiguous arrays of 64-bit integers and doubles.
+        const char fileMagic[8] = { 'Q', 'L', 'A', 'F', 'I', 'X', '0', '1' };
+
+        struct FileHeader {
+            char magic[8];
+            boost::uint64_t nameLength;
+            boost::uint64_t size;
+        };
+
+        boost::uint64_t padded(boost::uint64_t length) {
+            return (length + 7) / 8 * 8;
+        }
+
+        bool earlier(const std::pair<long, QuantLib::Real>& x,
+                     const std::pair<long, QuantLib::Real>& y) {
+            return x.first < y.first;
+        }
+
+        std::string duplicatedFixing(long date, QuantLib::Real value,
+                                     QuantLib::Real existing) {
+            std::ostringstream message;
+            message << "At least one duplicated fixing provided: ("
+                    << QuantLib::Date(date) << ", " << value << ") while "
+                    << existing << " value is already present";
+            return message.str();
+        }
+
+    }
+
+    FixingStore& FixingStore::instance() {
+        static FixingStore store;
+        return store;
+    }
+
+    FixingColumns FixingStore::columns(const QuantLib::Index& index) {
+        const QuantLib::TimeSeries<QuantLib::Real>& history = index.timeSeries();
+        FixingColumns columns;
+        columns.dates.reserve(history.size());
+        columns.values.reserve(history.size());
+        for (QuantLib::TimeSeries<QuantLib::Real>::const_iterator i = history.begin();
+             i != history.end(); ++i) {
+            columns.dates.push_back(i->first.serialNumber());
+            columns.values.push_back(i->second);
+        }
+        return columns;
+    }
+
+    QuantLib::Size FixingStore::addFixings(QuantLib::Index& index,
+                                           const std::vector<QuantLib::Date>& dates,
+                                           const std::vector<QuantLib::Real>& values,
+                                           bool forceOverwrite) {
+        QL_REQUIRE(dates.size()==values.size(),
+                   "size mismatch between dates (" << dates.size() <<
+                   ") and values (" << values.size() << ")");
+
+        // sort the new fixings; among fixings for the same date, the last
+        // one wins when overwriting and all must agree otherwise
+        std::vector<std::pair<long, QuantLib::Real> > fixings;
+        fixings.reserve(dates.size());
+        for (QuantLib::Size i=0; i<dates.size(); ++i) {
+            if (values[i] != QuantLib::Null<QuantLib::Real>())
+                fixings.push_back(std::make_pair(dates[i].serialNumber(), values[i]));
+        }
+        std::stable_sort(fixings.begin(), fixings.end(), earlier);
+        QuantLib::Size unique = 0;
+        for (QuantLib::Size i=0; i<fixings.size(); ++i) {
+            if (unique > 0 && fixings[unique-1].first == fixings[i].first) {
+                if (forceOverwrite)
+                    fixings[unique-1].second = fixings[i].second;
+                else
+                    QL_REQUIRE(QuantLib::close_enough(fixings[unique-1].second,
+                                                      fixings[i].second),
+                               duplicatedFixing(fixings[i].first, fixings[i].second,
+                                                fixings[unique-1].second));
+            } else {
+                fixings[unique++] = fixings[i];
+            }
+        }
+        fixings.resize(unique);
+
+        boost::mutex::scoped_lock lock(mutex_);
+
+        // classify against the library history, which is what indices
+        // read, before changing anything
+        const QuantLib::TimeSeries<QuantLib::Real>& history = index.timeSeries();
+        std::vector<QuantLib::Date> d;
+        std::vector<QuantLib::Real> v;
+        d.reserve(fixings.size());
+        v.reserve(fixings.size());
+        for (QuantLib::Size i=0; i<fixings.size(); ++i) {
+            QuantLib::Date date(fixings[i].first);
+            QuantLib::Real existing = history[date];
+            if (existing != QuantLib::Null<QuantLib::Real>()) {
+                if (QuantLib::close_enough(existing, fixings[i].second))
+                    continue;
+                QL_REQUIRE(forceOverwrite,
+                           duplicatedFixing(fixings[i].first, fixings[i].second,
+                                            existing));
+            }
+            d.push_back(date);
+            v.push_back(fixings[i].second);
+        }
+        if (!d.empty()) {
+            index.addFixings(d.begin(), d.end(), v.begin(), true);
+            ++revisions_[boost::algorithm::to_upper_copy(index.name())];
+        }
+        return d.size();
+    }
+
+    void FixingStore::clearFixings(QuantLib::Index& index) {
+        boost::mutex::scoped_lock lock(mutex_);
+        index.clearFixings();
+        ++revisions_[boost::algorithm::to_upper_copy(index.name())];
+    }
+
+    FixingColumns FixingStore::fixings(const QuantLib::Index& index) {
+        boost::mutex::scoped_lock lock(mutex_);
+        return columns(index);
+    }
+
+    QuantLib::Size FixingStore::revision(const QuantLib::Index& index) {
+        boost::mutex::scoped_lock lock(mutex_);
+        std::map<std::string, QuantLib::Size>::const_iterator i =
+            revisions_.find(boost::algorithm::to_upper_copy(index.name()));
+        return i == revisions_.end() ? 0 : i->second;
+    }
+
+    void FixingStore::save(const QuantLib::Index& index, const std::string& file) {
+        FixingColumns history = fixings(index);
+        std::string name = index.name();
+
+        FileHeader header;
+        std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+        header.nameLength = name.size();
+        header.size = history.dates.size();
+        std::vector<char> paddedName(padded(name.size()), '\0');
+        std::copy(name.begin(), name.end(), paddedName.begin());
+        std::vector<boost::int64_t> serials(history.dates.begin(), history.dates.end());
+
+        std::ofstream out(file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        QL_REQUIRE(out, "unable to open file " << file);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!paddedName.empty())
+            out.write(&paddedName[0], paddedName.size());
+        if (!serials.empty()) {
+            out.write(reinterpret_cast<const char*>(&serials[0]),
+                      serials.size()*sizeof(boost::int64_t));
+            out.write(reinterpret_cast<const char*>(&history.values[0]),
+                      history.values.size()*sizeof(QuantLib::Real));
+        }
+        QL_REQUIRE(out, "error writing file " << file);
+    }
+
+    std::string FixingStore::load(const std::string& file, FixingColumns& columns) {
+        boost::interprocess::file_mapping mapping(file.c_str(),
+                                                  boost::interprocess::read_only);
+        boost::interprocess::mapped_region region(mapping,
+                                                  boost::interprocess::read_only);
+        const char* data = static_cast<const char*>(region.get_address());
+        std::size_t length = region.get_size();
+
+        FileHeader header;
+        QL_REQUIRE(length >= sizeof(header), "file " << file << " is truncated");
+        std::memcpy(&header, data, sizeof(header));
+        QL_REQUIRE(std::equal(fileMagic, fileMagic + sizeof(fileMagic), header.magic),
+                   "file " << file << " is not a fixing file");
+        boost::uint64_t offset = sizeof(header) + padded(header.nameLength);
+        // checked by division, as a corrupted size could overflow the product
+        QL_REQUIRE(length >= offset &&
+                   header.size <= (length - offset)/(sizeof(boost::int64_t) +
+                                                     sizeof(QuantLib::Real)),
+                   "file " << file << " is truncated");
+
+        std::string name(data + sizeof(header), header.nameLength);
+        const boost::int64_t* serials =
+            reinterpret_cast<const boost::int64_t*>(data + offset);
+        const QuantLib::Real* values =
+            reinterpret_cast<const QuantLib::Real*>(serials + header.size);
+        columns.dates.assign(serials, serials + header.size);
+        columns.values.assign(values, values + header.size);
+        return name;
+    }
+
+}
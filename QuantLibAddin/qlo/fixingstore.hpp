@@ -0,0 +1,97 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Index fixings as sorted columns and binary files
+*/
+
+#ifndef qla_fixingstore_hpp
+#define qla_fixingstore_hpp
+
+#include <ql/time/date.hpp>
+
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace QuantLib {
+    class Index;
+}
+
+namespace QuantLibAddin {
+
+    //! Fixing history of an index family as sorted columns.
+    struct FixingColumns {
+        //! serial numbers of the fixing dates, in increasing order
+        std::vector<long> dates;
+        std::vector<QuantLib::Real> values;
+    };
+
+    //! Access to index fixings as columns.
+    /*! Nothing is cached here: the history of an index is the one kept by
+        QuantLib's IndexManager, which is what indices actually read and
+        which is shared among all indices with the same name.  New fixings
+        are checked against that history, and adding fixings which are
+        already stored leaves it untouched.  A revision number is kept for
+        each index name and increased whenever the history is changed
+        through this class, so that callers can tell whether a copy they
+        hold is still current.
+
+        Histories are returned as sorted date and value arrays, and can be
+        saved to and loaded from binary files holding the two columns
+        contiguously; files are memory mapped on load.
+    */
+    class FixingStore {
+      public:
+        static FixingStore& instance();
+
+        //! Add the given fixings to the index history.
+        /*! Null values are skipped.  The QuantLib history is only updated
+            with fixings which are new or changed; nothing is changed if a
+            duplicated fixing is found and forceOverwrite is false.
+            Returns the number of fixings added or changed.
+        */
+        QuantLib::Size addFixings(QuantLib::Index& index,
+                                  const std::vector<QuantLib::Date>& dates,
+                                  const std::vector<QuantLib::Real>& values,
+                                  bool forceOverwrite);
+        //! Remove the history of the given index.
+        void clearFixings(QuantLib::Index& index);
+        //! Copy of the history of the given index.
+        FixingColumns fixings(const QuantLib::Index& index);
+        //! Number of changes made to the history of the given index.
+        QuantLib::Size revision(const QuantLib::Index& index);
+
+        //! Write the history of the given index to a file.
+        void save(const QuantLib::Index& index, const std::string& file);
+        //! Read a file written by save().
+        /*! Returns the name of the index whose history the file holds. */
+        static std::string load(const std::string& file, FixingColumns& columns);
+
+      private:
+        FixingStore() {}
+        static FixingColumns columns(const QuantLib::Index& index);
+        boost::mutex mutex_;
+        // keyed by the upper-case names used by the IndexManager
+        std::map<std::string, QuantLib::Size> revisions_;
+    };
+
+}
+
+#endif
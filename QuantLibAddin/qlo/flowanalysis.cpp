@@ -26,13 +26,138 @@
 #include <ql/cashflows/capflooredcoupon.hpp>
 #include <ql/cashflows/digitalcoupon.hpp>
 #include <ql/indexes/interestrateindex.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <algorithm>
 
 using QuantLib::Visitor;
+using QuantLib::Real;
+using QuantLib::Size;
+using QuantLib::Null;
 using std::vector;
 using ObjectHandler::property_t;
 
 namespace QuantLibAddin {
 
+    namespace {
+
+        const char* headings[FlowColumns::numberOfFields] = {
+            "Payment Date", "Amount", "Nominal", "Accrual Start Date",
+            "Accrual End Date", "Accrual Days", "Index", "Fixing Days",
+            "Fixing Dates", "Day Counter", "Accrual Period", "Effective Rate",
+            "Floor", "Gearing", "Index Fixing", "Conv. Adj.", "Spread", "Cap",
+            "Call Digital Payoff", "Put Digital Payoff"
+        };
+
+        // fields shown as integers in the grid
+        bool isInteger(FlowColumns::Field field) {
+            switch (field) {
+              case FlowColumns::PaymentDate:
+              case FlowColumns::AccrualStartDate:
+              case FlowColumns::AccrualEndDate:
+              case FlowColumns::AccrualDays:
+              case FlowColumns::FixingDays:
+              case FlowColumns::FixingDate:
+                return true;
+              default:
+                return false;
+            }
+        }
+
+    }
+
+    std::string FlowColumns::heading(Field field) {
+        return headings[field];
+    }
+
+    FlowColumns::Field FlowColumns::field(const std::string& heading) {
+        for (Size i=0; i<numberOfFields; ++i) {
+            if (boost::iequals(heading, headings[i]))
+                return Field(i);
+        }
+        QL_FAIL("unknown flow analysis column: " << heading);
+    }
+
+    bool FlowColumns::isText(Field field) {
+        return field == Index || field == DayCounter;
+    }
+
+    FlowColumns::FlowColumns(const vector<Field>& fields)
+    : fields_(fields), slot_(numberOfFields, -1), size_(0) {
+        for (Size i=0; i<fields.size(); ++i) {
+            QL_REQUIRE(slot_[fields[i]] == -1,
+                       "flow analysis column " << heading(fields[i]) <<
+                       " given more than once");
+            if (isText(fields[i])) {
+                slot_[fields[i]] = static_cast<int>(text_.size());
+                text_.push_back(vector<std::string>());
+            } else {
+                slot_[fields[i]] = static_cast<int>(values_.size());
+                values_.push_back(vector<Real>());
+            }
+        }
+    }
+
+    const vector<Real>& FlowColumns::values(Field field) const {
+        QL_REQUIRE(selected(field) && !isText(field),
+                   "no numeric flow analysis column " << heading(field));
+        return values_[slot_[field]];
+    }
+
+    const vector<std::string>& FlowColumns::text(Field field) const {
+        QL_REQUIRE(selected(field) && isText(field),
+                   "no text flow analysis column " << heading(field));
+        return text_[slot_[field]];
+    }
+
+    void FlowColumns::addFlow() {
+        for (Size i=0; i<values_.size(); ++i)
+            values_[i].push_back(Null<Real>());
+        for (Size i=0; i<text_.size(); ++i)
+            text_[i].push_back(std::string());
+        ++size_;
+    }
+
+    void FlowColumns::set(Field field, Real value) {
+        if (selected(field))
+            values_[slot_[field]].back() = value;
+    }
+
+    void FlowColumns::set(Field field, const std::string& value) {
+        if (selected(field))
+            text_[slot_[field]].back() = value;
+    }
+
+    vector<vector<property_t> > FlowColumns::grid() const {
+        vector<vector<property_t> > flows;
+        flows.reserve(size_+1);
+        vector<property_t> row(fields_.size());
+        for (Size j=0; j<fields_.size(); ++j)
+            row[j] = heading(fields_[j]);
+        flows.push_back(row);
+        for (Size i=0; i<size_; ++i) {
+            for (Size j=0; j<fields_.size(); ++j) {
+                Field field = fields_[j];
+                if (isText(field)) {
+                    const std::string& value = text_[slot_[field]][i];
+                    if (value.empty())
+                        row[j] = std::string("#N/A");
+                    else
+                        row[j] = value;
+                } else {
+                    Real value = values_[slot_[field]][i];
+                    if (value == Null<Real>())
+                        row[j] = std::string("#N/A");
+                    else if (isInteger(field))
+                        row[j] = static_cast<long>(value);
+                    else
+                        row[j] = value;
+                }
+            }
+            flows.push_back(row);
+        }
+        return flows;
+    }
+
     class AnalysisGenerator : public QuantLib::AcyclicVisitor,
                               public Visitor<QuantLib::CashFlow>,
                               public Visitor<QuantLib::Coupon>,
@@ -40,176 +165,150 @@ namespace QuantLibAddin {
                               public Visitor<QuantLib::CappedFlooredCoupon>,
                               public Visitor<QuantLib::DigitalCoupon> {
       private:
-        vector<vector<property_t> > flows_;
-        static const QuantLib::Size numberOfColumns_ = 20;
+        FlowColumns& flows_;
+        void visitFloating(QuantLib::FloatingRateCoupon& c);
       public:
-        AnalysisGenerator();
-        void reset();
+        AnalysisGenerator(FlowColumns& flows) : flows_(flows) {}
         void visit(QuantLib::CashFlow& c);
         void visit(QuantLib::Coupon& c);
         void visit(QuantLib::FloatingRateCoupon& c);
         void visit(QuantLib::CappedFlooredCoupon& c);
         void visit(QuantLib::DigitalCoupon& c);
-        const vector<vector<property_t> >& analysis() const;
     };
 
-#define PAYMENT_DATE 0
-#define AMOUNT 1
-#define NOMINAL 2
-#define ACCRUAL_START_DATE 3
-#define ACCRUAL_END_DATE 4
-#define ACCRUAL_DAYS 5
-#define INDEX 6
-#define FIXING_DAYS 7
-#define FIXING_DATES 8
-#define DAY_COUNTER 9
-#define ACCRUAL_PERIOD 10
-#define EFFECTIVE_RATE 11
-#define FLOOR 12
-#define GEARING 13
-#define INDEX_FIXING 14
-#define CONV_ADJ 15
-#define SPREAD 16
-#define CAP 17
-#define CALLDIGITALRATE 18
-#define PUTDIGITALRATE 19
-
-    AnalysisGenerator::AnalysisGenerator() { reset(); }
-
-    void AnalysisGenerator::reset() {
-        flows_.clear();
-
-        vector<property_t> headings(numberOfColumns_);
-        headings[PAYMENT_DATE]=std::string("Payment Date");
-        headings[AMOUNT]=std::string("Amount");
-
-        headings[NOMINAL]=std::string("Nominal");
-        headings[ACCRUAL_START_DATE]=std::string("Accrual Start Date");
-        headings[ACCRUAL_END_DATE]=std::string("Accrual End Date");
-        headings[ACCRUAL_DAYS]=std::string("Accrual Days");
-        headings[DAY_COUNTER]=std::string("Day Counter");
-        headings[ACCRUAL_PERIOD]=std::string("Accrual Period");
-        headings[EFFECTIVE_RATE]=std::string("Effective Rate");
-
-        headings[FIXING_DAYS]=std::string("Fixing Days");
-        headings[FIXING_DATES]=std::string("Fixing Dates");
-        headings[INDEX]=std::string("Index");
-        headings[FLOOR]=std::string("Floor");
-        headings[GEARING]=std::string("Gearing");
-        headings[INDEX_FIXING]=std::string("Index Fixing");
-        headings[CONV_ADJ]=std::string("Conv. Adj.");
-        headings[SPREAD]=std::string("Spread");
-        headings[CAP]=std::string("Cap");
-        headings[PUTDIGITALRATE]=std::string("Put Digital Payoff");
-        headings[CALLDIGITALRATE]=std::string("Call Digital Payoff");
-
-        flows_.push_back(headings);
-    }
-
+    // Values are only calculated for the selected fields; errors leave
+    // the field empty.
     void AnalysisGenerator::visit(QuantLib::CashFlow& c) {
-        vector<property_t> cf(numberOfColumns_, std::string("#N/A"));
-        cf[PAYMENT_DATE]=c.date().serialNumber();
-        try {
-            cf[AMOUNT]=c.amount();
-        } catch(...) {}
-        flows_.push_back(cf);
+        flows_.addFlow();
+        flows_.set(FlowColumns::PaymentDate, c.date().serialNumber());
+        if (flows_.selected(FlowColumns::Amount)) {
+            try {
+                flows_.set(FlowColumns::Amount, c.amount());
+            } catch(...) {}
+        }
     }
 
     void AnalysisGenerator::visit(QuantLib::Coupon& c) {
         visit(static_cast<QuantLib::CashFlow&>(c));
-        flows_.back()[NOMINAL]=c.nominal();
-        flows_.back()[ACCRUAL_START_DATE]=c.accrualStartDate().serialNumber();
-        flows_.back()[ACCRUAL_END_DATE]=c.accrualEndDate().serialNumber();
-        flows_.back()[ACCRUAL_DAYS]=(long)c.accrualDays();
-        flows_.back()[DAY_COUNTER]=c.dayCounter().name();
-        flows_.back()[ACCRUAL_PERIOD]=c.accrualPeriod();
-        try {
-            flows_.back()[EFFECTIVE_RATE]=c.rate();
-        } catch(...) {}
-    };
+        flows_.set(FlowColumns::Nominal, c.nominal());
+        flows_.set(FlowColumns::AccrualStartDate, c.accrualStartDate().serialNumber());
+        flows_.set(FlowColumns::AccrualEndDate, c.accrualEndDate().serialNumber());
+        flows_.set(FlowColumns::AccrualDays, c.accrualDays());
+        if (flows_.selected(FlowColumns::DayCounter))
+            flows_.set(FlowColumns::DayCounter, c.dayCounter().name());
+        flows_.set(FlowColumns::AccrualPeriod, c.accrualPeriod());
+        if (flows_.selected(FlowColumns::EffectiveRate)) {
+            try {
+                flows_.set(FlowColumns::EffectiveRate, c.rate());
+            } catch(...) {}
+        }
+    }
 
-    void AnalysisGenerator::visit(QuantLib::FloatingRateCoupon& c) {
+    void AnalysisGenerator::visitFloating(QuantLib::FloatingRateCoupon& c) {
         visit(static_cast<QuantLib::Coupon&>(c));
-        flows_.back()[FIXING_DAYS]=(long)c.fixingDays();
-        flows_.back()[FIXING_DATES]=c.fixingDate().serialNumber();
-        flows_.back()[INDEX]=c.index()->name();
-        flows_.back()[FLOOR]=std::string("#N/A");
-        flows_.back()[GEARING]=c.gearing();
-        try {
-            flows_.back()[INDEX_FIXING]=c.indexFixing();
-        } catch(...) {}
-        try {
-            flows_.back()[CONV_ADJ]=c.convexityAdjustment();
-        } catch(...) {}
-        flows_.back()[SPREAD]=c.spread();
-        flows_.back()[CAP]=std::string("#N/A");
+        flows_.set(FlowColumns::FixingDays, c.fixingDays());
+        flows_.set(FlowColumns::FixingDate, c.fixingDate().serialNumber());
+        if (flows_.selected(FlowColumns::Index))
+            flows_.set(FlowColumns::Index, c.index()->name());
+        flows_.set(FlowColumns::Gearing, c.gearing());
+        if (flows_.selected(FlowColumns::IndexFixing)) {
+            try {
+                flows_.set(FlowColumns::IndexFixing, c.indexFixing());
+            } catch(...) {}
+        }
+        flows_.set(FlowColumns::Spread, c.spread());
+    }
+
+    void AnalysisGenerator::visit(QuantLib::FloatingRateCoupon& c) {
+        visitFloating(c);
+        if (flows_.selected(FlowColumns::ConvexityAdjustment)) {
+            try {
+                flows_.set(FlowColumns::ConvexityAdjustment, c.convexityAdjustment());
+            } catch(...) {}
+        }
     }
 
     void AnalysisGenerator::visit(QuantLib::CappedFlooredCoupon& c) {
-        visit(static_cast<QuantLib::Coupon&>(c));
-        flows_.back()[FIXING_DAYS]=(long)c.fixingDays();
-        flows_.back()[FIXING_DATES]=c.fixingDate().serialNumber();
-        flows_.back()[INDEX]=c.index()->name();
-        if (c.floor() != QuantLib::Null<QuantLib::Rate>())
-            flows_.back()[FLOOR]=c.floor();
-        else
-            flows_.back()[FLOOR]=std::string("#N/A");
-        flows_.back()[GEARING]=c.gearing();
-        try {
-            flows_.back()[INDEX_FIXING]=c.indexFixing();
-        } catch(...) {}
-        try {
-            flows_.back()[CONV_ADJ]=c.convexityAdjustment();
-        } catch(...) {}
-        flows_.back()[SPREAD]=c.spread();
-        if (c.cap() != QuantLib::Null<QuantLib::Rate>())
-            flows_.back()[CAP]=c.cap();
-        else
-            flows_.back()[CAP]=std::string("#N/A");
+        visit(static_cast<QuantLib::FloatingRateCoupon&>(c));
+        // Null<Rate>() when absent, which leaves the field empty
+        flows_.set(FlowColumns::Floor, c.floor());
+        flows_.set(FlowColumns::Cap, c.cap());
     }
 
     void AnalysisGenerator::visit(QuantLib::DigitalCoupon& c) {
-        visit(static_cast<QuantLib::Coupon&>(c));
-        flows_.back()[FIXING_DAYS]=(long)c.fixingDays();
-        flows_.back()[FIXING_DATES]=c.fixingDate().serialNumber();
-        flows_.back()[INDEX]=c.index()->name();
+        visitFloating(c);
+        if (flows_.selected(FlowColumns::ConvexityAdjustment)) {
+            try {
+                flows_.set(FlowColumns::ConvexityAdjustment,
+                           c.underlying()->convexityAdjustment());
+            } catch(...) {}
+        }
         if (c.hasPut())
-            flows_.back()[FLOOR]=c.putStrike();
-        else
-            flows_.back()[FLOOR]=std::string("#N/A");
-        flows_.back()[GEARING]=c.gearing();
-        try {
-            flows_.back()[INDEX_FIXING]=c.indexFixing();
-        } catch(...) {}
-        try {
-            flows_.back()[CONV_ADJ]=c.underlying()->convexityAdjustment();
-        } catch(...) {}
-        flows_.back()[SPREAD]=c.spread();
+            flows_.set(FlowColumns::Floor, c.putStrike());
         if (c.hasCall())
-            flows_.back()[CAP]=c.callStrike();
-        else
-            flows_.back()[CAP]=std::string("#N/A");
-        if (c.putDigitalPayoff() != QuantLib::Null<QuantLib::Rate>())
-            flows_.back()[PUTDIGITALRATE]=c.putDigitalPayoff();
-        else
-            flows_.back()[PUTDIGITALRATE]=std::string("#N/A");
-        if (c.callDigitalPayoff() != QuantLib::Null<QuantLib::Rate>())
-            flows_.back()[CALLDIGITALRATE]=c.callDigitalPayoff();
-        else
-            flows_.back()[CALLDIGITALRATE]=std::string("#N/A");
+            flows_.set(FlowColumns::Cap, c.callStrike());
+        flows_.set(FlowColumns::PutDigitalPayoff, c.putDigitalPayoff());
+        flows_.set(FlowColumns::CallDigitalPayoff, c.callDigitalPayoff());
     }
 
-    const vector<vector<property_t> >& AnalysisGenerator::analysis() const {
-        return flows_;
+    FlowColumns flowColumns(const QuantLib::Leg& leg,
+                            const QuantLib::Date& d,
+                            const vector<FlowColumns::Field>& fields) {
+        FlowColumns flows(fields);
+        AnalysisGenerator generator(flows);
+        for (Size i=0; i<leg.size(); ++i) {
+            if (leg[i]->date()>d)
+            leg[i]->accept(generator);
+        }
+        return flows;
     }
 
     vector<vector<property_t> > flowAnalysis(const QuantLib::Leg& leg,
                                              const QuantLib::Date& d) {
-        AnalysisGenerator generator;
-        for (QuantLib::Size i=0; i<leg.size(); ++i) {
-            if (leg[i]->date()>d)
-            leg[i]->accept(generator);
+        return flowAnalysis(leg, d, vector<std::string>());
+    }
+
+    vector<vector<property_t> > flowAnalysis(const QuantLib::Leg& leg,
+                                             const QuantLib::Date& d,
+                                             const vector<std::string>& columns) {
+        vector<FlowColumns::Field> fields;
+        if (columns.empty()) {
+            for (Size i=0; i<FlowColumns::numberOfFields; ++i)
+                fields.push_back(FlowColumns::Field(i));
+        } else {
+            for (Size i=0; i<columns.size(); ++i)
+                fields.push_back(FlowColumns::field(columns[i]));
         }
-        return generator.analysis();
+        return flowColumns(leg, d, fields).grid();
     }
+
+    vector<vector<Real> > flowLadder(const vector<const QuantLib::Leg*>& legs,
+                                     const vector<QuantLib::Date>& bucketDates,
+                                     const QuantLib::Date& d) {
+        QL_REQUIRE(!bucketDates.empty(), "no bucket dates given");
+        for (Size j=1; j<bucketDates.size(); ++j)
+            QL_REQUIRE(bucketDates[j-1] < bucketDates[j],
+                       "bucket dates must be sorted in increasing order");
+
+        vector<vector<Real> > ladder(legs.size(),
+                                     vector<Real>(bucketDates.size(), 0.0));
+        for (Size i=0; i<legs.size(); ++i) {
+            const QuantLib::Leg& leg = *legs[i];
+            for (Size k=0; k<leg.size(); ++k) {
+                QuantLib::Date date = leg[k]->date();
+                if (date<=d || date>bucketDates.back())
+                    continue;
+                Size j = std::lower_bound(bucketDates.begin(), bucketDates.end(),
+                                          date) - bucketDates.begin();
+                try {
+                    ladder[i][j] += leg[k]->amount();
+                } catch (std::exception& e) {
+                    QL_FAIL("leg #" << i+1 << ", flow paid on " << date <<
+                            ": " << e.what());
+                }
+            }
+        }
+        return ladder;
+    }
+
 }
@@ -22,8 +22,10 @@
 #define qla_analysis_hpp
 
 #include <boost/shared_ptr.hpp>
+#include <string>
 #include <vector>
 #include <oh/property.hpp>
+#include <ql/types.hpp>
 
 namespace QuantLib {
     class CashFlow;
@@ -33,10 +35,72 @@ namespace QuantLib {
 
 namespace QuantLibAddin {
 
+    // Cash-flow analysis stored as one array per field.  Numeric fields
+    // (dates as serial numbers) hold Null<Real>() where the field doesn't
+    // apply to a cash flow or can't be calculated; the index and day
+    // counter hold an empty string.  Only the selected fields are stored
+    // and calculated.
+    class FlowColumns {
+      public:
+        // in the order of the columns of flowAnalysis()
+        enum Field { PaymentDate, Amount, Nominal, AccrualStartDate,
+                     AccrualEndDate, AccrualDays, Index, FixingDays,
+                     FixingDate, DayCounter, AccrualPeriod, EffectiveRate,
+                     Floor, Gearing, IndexFixing, ConvexityAdjustment,
+                     Spread, Cap, CallDigitalPayoff, PutDigitalPayoff };
+        static const QuantLib::Size numberOfFields = 20;
+        static std::string heading(Field field);
+        // the field with the given heading, case insensitive
+        static Field field(const std::string& heading);
+        static bool isText(Field field);
+
+        explicit FlowColumns(const std::vector<Field>& fields);
+        const std::vector<Field>& fields() const { return fields_; }
+        bool selected(Field field) const { return slot_[field] != -1; }
+        QuantLib::Size size() const { return size_; }
+        const std::vector<QuantLib::Real>& values(Field field) const;
+        const std::vector<std::string>& text(Field field) const;
+
+        // used while the analysis is generated
+        void addFlow();
+        void set(Field field, QuantLib::Real value);
+        void set(Field field, const std::string& value);
+
+        // headings row followed by one row per flow, "#N/A" where empty
+        std::vector<std::vector<ObjectHandler::property_t> > grid() const;
+      private:
+        std::vector<Field> fields_;
+        std::vector<int> slot_;
+        std::vector<std::vector<QuantLib::Real> > values_;
+        std::vector<std::vector<std::string> > text_;
+        QuantLib::Size size_;
+    };
+
+    // analysis of the flows paid after the given date
+    FlowColumns flowColumns(const QuantLib::Leg& leg,
+                            const QuantLib::Date& d,
+                            const std::vector<FlowColumns::Field>& fields);
+
     std::vector<std::vector<ObjectHandler::property_t> >
     flowAnalysis(const QuantLib::Leg& leg,
                  const QuantLib::Date& d);
 
+    // as above, restricted to the columns with the given headings (all
+    // columns if none are given)
+    std::vector<std::vector<ObjectHandler::property_t> >
+    flowAnalysis(const QuantLib::Leg& leg,
+                 const QuantLib::Date& d,
+                 const std::vector<std::string>& columns);
+
+    // Amounts paid after the given date, one row per leg and one column
+    // per bucket; bucket i holds the flows paid after bucket date i-1 and
+    // on or before bucket date i.  Flows after the last bucket date are
+    // not included.
+    std::vector<std::vector<QuantLib::Real> >
+    flowLadder(const std::vector<const QuantLib::Leg*>& legs,
+               const std::vector<QuantLib::Date>& bucketDates,
+               const QuantLib::Date& d);
+
 }
 
 #endif
@@ -0,0 +1,49 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <qlo/config.hpp>
+#endif
+#include <qlo/incrementalbootstrap.hpp>
+
+namespace QuantLibAddin {
+
+    std::vector<std::vector<ObjectHandler::property_t> > bootstrapStatistics(
+                                    const BootstrapStatistics& statistics) {
+        std::vector<std::vector<ObjectHandler::property_t> > result(7,
+                                    std::vector<ObjectHandler::property_t>(2));
+        result[0][0] = std::string("Bootstraps");
+        result[0][1] = static_cast<long>(statistics.bootstraps);
+        result[1][0] = std::string("Full Bootstraps");
+        result[1][1] = static_cast<long>(statistics.fullBootstraps);
+        result[2][0] = std::string("First Pillar");
+        result[2][1] = static_cast<long>(statistics.firstPillar);
+        result[3][0] = std::string("Pillars Solved");
+        result[3][1] = static_cast<long>(statistics.pillarsSolved);
+        result[4][0] = std::string("Iterations");
+        result[4][1] = static_cast<long>(statistics.improvements.size());
+        result[5][0] = std::string("Last Improvement");
+        if (statistics.improvements.empty())
+            result[5][1] = std::string("N/A");
+        else
+            result[5][1] = statistics.improvements.back();
+        result[6][0] = std::string("Elapsed");
+        result[6][1] = statistics.elapsed;
+        return result;
+    }
+
+}
@@ -0,0 +1,340 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Bootstrap restarting from the first pillar whose quote moved
+*/
+
+#ifndef qla_incrementalbootstrap_hpp
+#define qla_incrementalbootstrap_hpp
+
+#include <qlo/parallel.hpp>
+#include <oh/property.hpp>
+
+#include <ql/termstructures/bootstraperror.hpp>
+#include <ql/termstructures/bootstraphelper.hpp>
+#include <ql/math/interpolations/linearinterpolation.hpp>
+#include <ql/math/solvers1d/brent.hpp>
+#include <ql/math/solvers1d/finitedifferencenewtonsafe.hpp>
+#include <ql/utilities/dataformatters.hpp>
+
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace QuantLibAddin {
+
+    //! Diagnostics of the bootstraps run by an IncrementalBootstrap.
+    struct BootstrapStatistics {
+        BootstrapStatistics()
+        : bootstraps(0), fullBootstraps(0), firstPillar(0),
+          pillarsSolved(0), elapsed(0.0) {}
+        //! number of bootstraps run so far
+        QuantLib::Size bootstraps;
+        //! number of them solving the curve from its first pillar
+        QuantLib::Size fullBootstraps;
+        //! first pillar (1-based) solved by the last bootstrap
+        QuantLib::Size firstPillar;
+        //! number of pillars solved by the last bootstrap
+        QuantLib::Size pillarsSolved;
+        //! largest change of the curve data at each iteration of the last bootstrap
+        std::vector<QuantLib::Real> improvements;
+        //! wall-clock time of the last bootstrap in seconds
+        QuantLib::Real elapsed;
+    };
+
+    //! Statistics as a two-column matrix of names and values.
+    std::vector<std::vector<ObjectHandler::property_t> > bootstrapStatistics(
+                                    const BootstrapStatistics& statistics);
+
+    //! Iterative bootstrap restarting from the first pillar whose quote moved.
+    /*! Same algorithm as QuantLib::IterativeBootstrap.  When the curve was
+        already bootstrapped, only the quote of the helper at pillar k (or
+        later) moved, and the interpolation is local with each helper
+        depending on the curve up to its own pillar, the solutions at the
+        pillars before k are still valid; only pillars k and later are
+        solved again, starting from their previous values.
+
+        Other market data a helper depends upon (e.g. an exogenous
+        discount curve, a convexity adjustment or a fixing) may have moved
+        together with the quotes.  The quote error of each helper is
+        therefore recorded after each bootstrap, and the pillars before k
+        are only kept if their helpers still reprice with the same error
+        within the accuracy; the bootstrap restarts at the first one which
+        does not.
+
+        Whenever the above cannot be established (first bootstrap, moving
+        reference date, global interpolation, helpers extending beyond
+        their pillar, or a notification not coming from a helper quote)
+        the whole curve is bootstrapped again, still starting from the
+        previous solution.
+
+        The statistics object is shared between copies of the bootstrap,
+        so that the caller can keep a reference to it while the curve
+        holds its own copy.
+    */
+    template <class Curve>
+    class IncrementalBootstrap {
+        typedef typename Curve::traits_type Traits;
+        typedef typename Curve::interpolator_type Interpolator;
+      public:
+        explicit IncrementalBootstrap(
+            const boost::shared_ptr<BootstrapStatistics>& statistics
+                = boost::shared_ptr<BootstrapStatistics>(),
+            QuantLib::Real accuracy = 1.0e-12)
+        : ts_(0), n_(0), accuracy_(accuracy), statistics_(statistics),
+          initialized_(false), validCurve_(false), loopRequired_(false),
+          firstAliveHelper_(0), alive_(0) {
+            if (!statistics_)
+                statistics_ = boost::make_shared<BootstrapStatistics>();
+        }
+        void setup(Curve* ts);
+        void calculate() const;
+      private:
+        void initialize() const;
+        void solve(QuantLib::Size i, bool validData) const;
+        Curve* ts_;
+        QuantLib::Size n_;
+        QuantLib::Real accuracy_;
+        boost::shared_ptr<BootstrapStatistics> statistics_;
+        QuantLib::Brent firstSolver_;
+        QuantLib::FiniteDifferenceNewtonSafe solver_;
+        mutable bool initialized_, validCurve_, loopRequired_;
+        mutable QuantLib::Size firstAliveHelper_, alive_;
+        mutable std::vector<QuantLib::Real> previousData_, quotes_, quoteErrors_;
+        mutable std::vector<boost::shared_ptr<
+                           QuantLib::BootstrapError<Curve> > > errors_;
+    };
+
+
+    // template definitions
+
+    template <class Curve>
+    void IncrementalBootstrap<Curve>::setup(Curve* ts) {
+        ts_ = ts;
+        n_ = ts_->instruments_.size();
+        QL_REQUIRE(n_ > 0, "no bootstrap helpers given");
+        for (QuantLib::Size j=0; j<n_; ++j)
+            ts_->registerWith(ts_->instruments_[j]);
+        // helpers might not be usable yet: initialization is
+        // deferred until the curve is first calculated
+    }
+
+    template <class Curve>
+    void IncrementalBootstrap<Curve>::initialize() const {
+        std::sort(ts_->instruments_.begin(), ts_->instruments_.end(),
+                  QuantLib::detail::BootstrapHelperSorter());
+
+        QuantLib::Date firstDate = Traits::initialDate(ts_);
+        QL_REQUIRE(ts_->instruments_[n_-1]->pillarDate() > firstDate,
+                   "all instruments expired");
+        firstAliveHelper_ = 0;
+        while (ts_->instruments_[firstAliveHelper_]->pillarDate() <= firstDate)
+            ++firstAliveHelper_;
+        alive_ = n_ - firstAliveHelper_;
+        QL_REQUIRE(alive_ >= Interpolator::requiredPoints-1,
+                   "not enough alive instruments: " << alive_ <<
+                   " provided, " << Interpolator::requiredPoints-1 <<
+                   " required");
+
+        std::vector<QuantLib::Date>& dates = ts_->dates_;
+        std::vector<QuantLib::Time>& times = ts_->times_;
+        std::vector<QuantLib::Date> previousDates = dates;
+        dates.resize(alive_+1);
+        times.resize(alive_+1);
+        errors_.resize(alive_+1);
+        dates[0] = firstDate;
+        times[0] = ts_->timeFromReference(dates[0]);
+
+        loopRequired_ = Interpolator::global;
+        QuantLib::Date latestRelevantDate, maxDate = firstDate;
+        for (QuantLib::Size i=1, j=firstAliveHelper_; j<n_; ++i, ++j) {
+            const boost::shared_ptr<typename Traits::helper>& helper =
+                                                    ts_->instruments_[j];
+            dates[i] = helper->pillarDate();
+            times[i] = ts_->timeFromReference(dates[i]);
+            QL_REQUIRE(dates[i-1] != dates[i],
+                       "more than one instrument with pillar " << dates[i]);
+            latestRelevantDate = helper->latestRelevantDate();
+            QL_REQUIRE(latestRelevantDate > maxDate,
+                       QuantLib::io::ordinal(j+1) << " instrument (pillar: " <<
+                       dates[i] << ") has latestRelevantDate (" <<
+                       latestRelevantDate << ") before or equal to "
+                       "previous instrument's latestRelevantDate (" <<
+                       maxDate << ")");
+            maxDate = latestRelevantDate;
+            // a helper extending beyond its pillar depends on later pillars
+            if (dates[i] != latestRelevantDate)
+                loopRequired_ = true;
+            errors_[i] = boost::make_shared<QuantLib::BootstrapError<Curve> >(
+                                                              ts_, helper, i);
+        }
+        ts_->maxDate_ = maxDate;
+
+        if (!validCurve_ || ts_->data_.size() != alive_+1) {
+            ts_->data_ = std::vector<QuantLib::Real>(alive_+1,
+                                                     Traits::initialValue(ts_));
+            validCurve_ = false;
+        }
+        // a moving curve is initialized again at each calculation, but
+        // the previous solutions can only be kept if its pillars did not move
+        if (dates != previousDates)
+            quotes_.clear();
+        initialized_ = true;
+    }
+
+    template <class Curve>
+    void IncrementalBootstrap<Curve>::solve(QuantLib::Size i,
+                                            bool validData) const {
+        const std::vector<QuantLib::Time>& times = ts_->times_;
+        const std::vector<QuantLib::Real>& data = ts_->data_;
+
+        QuantLib::Real min =
+            Traits::minValueAfter(i, ts_, validData, firstAliveHelper_);
+        QuantLib::Real max =
+            Traits::maxValueAfter(i, ts_, validData, firstAliveHelper_);
+        QuantLib::Real guess =
+            Traits::guess(i, ts_, validData, firstAliveHelper_);
+        if (guess >= max)
+            guess = max - (max-min)/5.0;
+        else if (guess <= min)
+            guess = min + (max-min)/5.0;
+
+        if (!validData) {
+            // extend the interpolation to the pillar being solved
+            try {
+                ts_->interpolation_ = ts_->interpolator_.interpolate(
+                                times.begin(), times.begin()+i+1, data.begin());
+            } catch (...) {
+                if (!Interpolator::global)
+                    throw;
+                // use linear interpolation until enough points are available
+                ts_->interpolation_ = QuantLib::Linear().interpolate(
+                                times.begin(), times.begin()+i+1, data.begin());
+            }
+            ts_->interpolation_.update();
+        }
+
+        if (validData)
+            solver_.solve(*errors_[i], accuracy_, guess, min, max);
+        else
+            firstSolver_.solve(*errors_[i], accuracy_, guess, min, max);
+    }
+
+    template <class Curve>
+    void IncrementalBootstrap<Curve>::calculate() const {
+        WallTimer timer;
+
+        // helpers relative to the evaluation date move with the curve
+        if (!initialized_ || ts_->moving_)
+            initialize();
+
+        std::vector<QuantLib::Real> quotes(alive_+1);
+        QuantLib::Size firstPillar = alive_+1;
+        for (QuantLib::Size i=1, j=firstAliveHelper_; j<n_; ++i, ++j) {
+            const boost::shared_ptr<typename Traits::helper>& helper =
+                                                    ts_->instruments_[j];
+            QL_REQUIRE(helper->quote()->isValid(),
+                       QuantLib::io::ordinal(j+1) << " instrument (maturity: " <<
+                       helper->maturityDate() << ", pillar: " <<
+                       helper->pillarDate() << ") has an invalid quote");
+            helper->setTermStructure(const_cast<Curve*>(ts_));
+            quotes[i] = helper->quote()->value();
+            if (firstPillar > alive_ &&
+                (quotes_.empty() || quotes[i] != quotes_[i]))
+                firstPillar = i;
+        }
+        // if no quote moved, something else did
+        if (!validCurve_ || loopRequired_ || firstPillar > alive_)
+            firstPillar = 1;
+        // something else might have moved as well: the pillars before
+        // the first moved quote are kept only if their helpers still
+        // reprice as they did after the last bootstrap
+        for (QuantLib::Size i=1; i<firstPillar; ++i) {
+            QuantLib::Real error = errors_[i]->helper()->quoteError();
+            if (!(std::fabs(error - quoteErrors_[i]) <= accuracy_)) {
+                firstPillar = i;
+                break;
+            }
+        }
+
+        const std::vector<QuantLib::Real>& data = ts_->data_;
+        std::vector<QuantLib::Real> improvements;
+        QuantLib::Size maxIterations = Traits::maxIterations()-1;
+        bool validData = validCurve_;
+
+        for (QuantLib::Size iteration=0; ; ++iteration) {
+            previousData_ = ts_->data_;
+
+            for (QuantLib::Size i=firstPillar; i<=alive_; ++i) {
+                try {
+                    solve(i, validData);
+                } catch (std::exception& e) {
+                    if (validCurve_) {
+                        // the previous solution might have been a bad
+                        // guess: start again from scratch
+                        validCurve_ = initialized_ = false;
+                        calculate();
+                        return;
+                    }
+                    QL_FAIL(QuantLib::io::ordinal(iteration+1) <<
+                            " iteration: failed at " <<
+                            QuantLib::io::ordinal(i) << " alive instrument, "
+                            "pillar " << errors_[i]->helper()->pillarDate() <<
+                            ", maturity " <<
+                            errors_[i]->helper()->maturityDate() <<
+                            ", reference date " << ts_->dates_[0] <<
+                            ": " << e.what());
+                }
+            }
+
+            QuantLib::Real change = 0.0;
+            for (QuantLib::Size i=firstPillar; i<=alive_; ++i)
+                change = std::max(change,
+                                  std::fabs(data[i]-previousData_[i]));
+            improvements.push_back(change);
+
+            if (!loopRequired_ || change <= accuracy_)
+                break;
+
+            QL_REQUIRE(iteration < maxIterations,
+                       "convergence not reached after " << iteration+1 <<
+                       " iterations; last improvement " << change <<
+                       ", required accuracy " << accuracy_);
+            validData = true;
+        }
+
+        quotes_.swap(quotes);
+        quoteErrors_.resize(alive_+1);
+        for (QuantLib::Size i=1; i<=alive_; ++i)
+            quoteErrors_[i] = errors_[i]->helper()->quoteError();
+        validCurve_ = true;
+
+        ++statistics_->bootstraps;
+        if (firstPillar == 1)
+            ++statistics_->fullBootstraps;
+        statistics_->firstPillar = firstPillar;
+        statistics_->pillarsSolved = alive_ - firstPillar + 1;
+        statistics_->improvements.swap(improvements);
+        statistics_->elapsed = timer.elapsed();
+    }
+
+}
+
+#endif
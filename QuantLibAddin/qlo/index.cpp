@@ -25,43 +25,58 @@
 #endif
 
 #include <qlo/index.hpp>
+#include <qlo/fixingstore.hpp>
 
-#include <ql/timeseries.hpp>
 #include <ql/index.hpp>
 
+#include <boost/algorithm/string/predicate.hpp>
+
 namespace QuantLibAddin {
 
     void Index::addFixings(const std::vector<QuantLib::Date>& dates,
                            const std::vector<QuantLib::Real>& values,
                            bool forceOverwrite, bool updateValuObject) {
-        QL_REQUIRE(dates.size()==values.size(),
-                   "size mismatch between dates (" << dates.size() <<
-                   ") and values (" << values.size() << ")");
-        std::vector<QuantLib::Date> d;
-        std::vector<QuantLib::Real> v;
-        for (QuantLib::Size i=0; i<values.size(); ++i) {
-            // skip null fixings
-            if (values[i]!=QuantLib::Null<QuantLib::Real>()) {
-                d.push_back(dates[i]);
-                v.push_back(values[i]);
-            }
-        }
-        libraryObject_->addFixings(d.begin(), d.end(),
-                                   v.begin(), forceOverwrite);
+        // null fixings are skipped and fixings already present are not
+        // added again to the library history
+        FixingStore::instance().addFixings(
+            *libraryObject_, dates, values, forceOverwrite);
+        // also when nothing was added here: the history may have been
+        // loaded before this object was created or through another index
+        if (updateValuObject)
+            updateValueObject();
+    }
+
+    void Index::clearFixings() {
+        FixingStore::instance().clearFixings(*libraryObject_);
+        updateValueObject();
+    }
+
+    void Index::saveFixings(const std::string& file) const {
+        FixingStore::instance().save(*libraryObject_, file);
+    }
+
+    void Index::loadFixings(const std::string& file, bool forceOverwrite) {
+        FixingColumns columns;
+        std::string name = FixingStore::load(file, columns);
+        QL_REQUIRE(boost::algorithm::iequals(name, libraryObject_->name()),
+                   "file " << file << " holds fixings for " << name <<
+                   ", not " << libraryObject_->name());
+        std::vector<QuantLib::Date> dates(columns.dates.size());
+        for (QuantLib::Size i=0; i<columns.dates.size(); ++i)
+            dates[i] = QuantLib::Date(columns.dates[i]);
+        addFixings(dates, columns.values, forceOverwrite);
+    }
 
-        if (updateValuObject) {
-            std::vector<long> fixingDates;
-            std::vector<QuantLib::Real> fixingRates;
-            const QuantLib::TimeSeries<QuantLib::Real>& history = libraryObject_->timeSeries();
-            for (QuantLib::TimeSeries<QuantLib::Real>::const_iterator hi = history.begin();
-                 hi != history.end(); ++hi) {
-                fixingDates.push_back(hi->first.serialNumber());
-                fixingRates.push_back(hi->second);
-            }
-            boost::shared_ptr<ObjectHandler::ValueObject> inst_properties = properties();
-            inst_properties->setProperty("IndexFixingDates", fixingDates);
-            inst_properties->setProperty("IndexFixingRates", fixingRates);
-        }
+    void Index::updateValueObject() {
+        // the properties are only rebuilt if the history changed since
+        QuantLib::Size revision = FixingStore::instance().revision(*libraryObject_);
+        if (revision == fixingsRevision_)
+            return;
+        fixingsRevision_ = revision;
+        FixingColumns history = FixingStore::instance().fixings(*libraryObject_);
+        boost::shared_ptr<ObjectHandler::ValueObject> inst_properties = properties();
+        inst_properties->setProperty("IndexFixingDates", history.dates);
+        inst_properties->setProperty("IndexFixingRates", history.values);
     }
 
 }
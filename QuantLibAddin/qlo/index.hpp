@@ -26,6 +26,10 @@
 #include <oh/libraryobject.hpp>
 
 #include <ql/types.hpp>
+#include <ql/utilities/null.hpp>
+
+#include <string>
+#include <vector>
 
 namespace QuantLib {
     class Date;
@@ -39,8 +43,19 @@ namespace QuantLibAddin {
         void addFixings(const std::vector<QuantLib::Date>& dates,
                         const std::vector<QuantLib::Real>& values,
                         bool forceOverwrite, bool updateValuObject = true);
+        void clearFixings();
+        // Fixing files hold the columns of the FixingStore
+        void saveFixings(const std::string& file) const;
+        void loadFixings(const std::string& file, bool forceOverwrite);
+      private:
+        void updateValueObject();
+        // revision of the FixingStore history shown in the properties
+        QuantLib::Size fixingsRevision_;
       public:
-        OH_LIB_CTOR(Index, QuantLib::Index);
+        Index(const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+              bool permanent)
+        : ObjectHandler::LibraryObject<QuantLib::Index>(properties, permanent),
+          fixingsRevision_(QuantLib::Null<QuantLib::Size>()) {}
     };
 
 }
@@ -117,8 +117,9 @@ namespace QuantLibAddin {
     }
 
     vector<vector<property_t> >
-    Leg::flowAnalysis(const QuantLib::Date& d) const {
-        return QuantLibAddin::flowAnalysis(*libraryObject_, d);
+    Leg::flowAnalysis(const QuantLib::Date& d,
+                      const vector<std::string>& columns) const {
+        return QuantLibAddin::flowAnalysis(*libraryObject_, d, columns);
     }
 
     MultiPhaseLeg::MultiPhaseLeg(const shared_ptr<ValueObject>& p,
@@ -151,4 +152,17 @@ namespace QuantLibAddin {
             QuantLib::InterestRate(r, dc, comp, freq));
     }
 
+
+    vector<vector<Real> > qlLegFlowLadder(const vector<shared_ptr<Leg> >& legs,
+                                          const vector<Date>& bucketDates,
+                                          const Date& afterDate) {
+        vector<shared_ptr<QuantLib::Leg> > qlLegs(legs.size());
+        vector<const QuantLib::Leg*> pointers(legs.size());
+        for (QuantLib::Size i=0; i<legs.size(); ++i) {
+            legs[i]->getLibraryObject(qlLegs[i]);
+            pointers[i] = qlLegs[i].get();
+        }
+        return flowLadder(pointers, bucketDates, afterDate);
+    }
+
 }
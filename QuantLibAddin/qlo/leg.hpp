@@ -58,7 +58,8 @@ namespace QuantLibAddin {
         void setCouponPricers(
             const std::vector<boost::shared_ptr<QuantLibAddin::FloatingRateCouponPricer> >&);
         std::vector<std::vector<ObjectHandler::property_t> > flowAnalysis(
-                                            const QuantLib::Date& d) const;
+                                const QuantLib::Date& d,
+                                const std::vector<std::string>& columns) const;
       protected:
         OH_LIB_CTOR(Leg, QuantLib::Leg)
     };
@@ -80,6 +81,12 @@ namespace QuantLibAddin {
                      QuantLib::Frequency freq,
                      bool permanent);
     };
+
+    // amounts paid by each leg in each bucket, see QuantLibAddin::flowLadder
+    std::vector<std::vector<QuantLib::Real> > qlLegFlowLadder(
+                        const std::vector<boost::shared_ptr<Leg> >& legs,
+                        const std::vector<QuantLib::Date>& bucketDates,
+                        const QuantLib::Date& afterDate);
 }
 
 #endif
@@ -50,6 +50,45 @@ namespace QuantLibAddin {
         return QuantLib::InverseCumulativeNormal(0.0, 1.0)(prob);
     }
 
+    //! Standard normal quantiles of n probabilities.
+    /*! Gives the same values as InverseCumulativeNormal.  The central
+        rational approximation is evaluated over the whole array in a
+        branch-free loop the compiler can vectorise, and the few values
+        in the tails are overwritten afterwards.
+    */
+    inline void normSInv(const QuantLib::Real* probs,
+                         QuantLib::Real* values,
+                         QuantLib::Size n) {
+        QuantLib::InverseCumulativeNormal inverse;
+        #if defined(QL_INVERSE_CUMULATIVE_NORMAL_REFINEMENT)
+        for (QuantLib::Size i=0; i<n; ++i)
+            values[i] = inverse(probs[i]);
+        #else
+        const QuantLib::Real a1 = -3.969683028665376e+01,
+                             a2 =  2.209460984245205e+02,
+                             a3 = -2.759285104469687e+02,
+                             a4 =  1.383577518672690e+02,
+                             a5 = -3.066479806614716e+01,
+                             a6 =  2.506628277459239e+00,
+                             b1 = -5.447609879822406e+01,
+                             b2 =  1.615858368580409e+02,
+                             b3 = -1.556989798598866e+02,
+                             b4 =  6.680131188771972e+01,
+                             b5 = -1.328068155288572e+01;
+        const QuantLib::Real low = 0.02425, high = 1.0 - low;
+        for (QuantLib::Size i=0; i<n; ++i) {
+            QuantLib::Real z = probs[i] - 0.5;
+            QuantLib::Real r = z*z;
+            values[i] = (((((a1*r+a2)*r+a3)*r+a4)*r+a5)*r+a6)*z /
+                (((((b1*r+b2)*r+b3)*r+b4)*r+b5)*r+1.0);
+        }
+        for (QuantLib::Size i=0; i<n; ++i) {
+            if (probs[i] < low || high < probs[i])
+                values[i] = inverse(probs[i]);
+        }
+        #endif
+    }
+
 }
 
 #endif
@@ -0,0 +1,164 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <qlo/config.hpp>
+#endif
+#include <qlo/parallel.hpp>
+#include <qlo/handle.hpp>
+#include <qlo/quote.hpp>
+#include <qlo/termstructures.hpp>
+#include <oh/iless.hpp>
+#include <oh/repository.hpp>
+#include <ql/patterns/lazyobject.hpp>
+#include <ql/termstructures/yieldtermstructure.hpp>
+#include <map>
+
+namespace QuantLibAddin {
+
+    QuantLib::Size workerThreads(QuantLib::Size requested) {
+        if (requested != 0)
+            return requested;
+        QuantLib::Size hardware = boost::thread::hardware_concurrency();
+        return hardware == 0 ? 1 : hardware;
+    }
+
+    namespace {
+
+        boost::shared_ptr<ObjectHandler::Object> retrieve(const std::string& id) {
+            boost::shared_ptr<ObjectHandler::Object> object;
+            ObjectHandler::Repository& repository =
+                ObjectHandler::Repository::instance();
+            if (!id.empty() &&
+                repository.objectExists(std::vector<std::string>(1, id))[0])
+                repository.retrieveObject(object, id);
+            return object;
+        }
+
+        // LazyObject::calculate() is protected; naming it through a derived
+        // class gives access to it without recalculating objects which are
+        // already up to date, as the public recalculate() would.
+        struct LazyCalculation : QuantLib::LazyObject {
+            static void run(const QuantLib::LazyObject& object) {
+                (object.*&LazyCalculation::calculate)();
+            }
+        };
+
+        QuantLib::Size root(std::vector<QuantLib::Size>& parent,
+                            QuantLib::Size i) {
+            while (parent[i] != i)
+                i = parent[i] = parent[parent[i]];
+            return i;
+        }
+
+    }
+
+    std::vector<std::vector<QuantLib::Size> > groupBySharedKeys(
+                        const std::vector<std::vector<std::string> >& keys) {
+        // union-find over the items, joining each item with the first
+        // item seen with the same key
+        std::vector<QuantLib::Size> parent(keys.size());
+        for (QuantLib::Size i=0; i<keys.size(); ++i)
+            parent[i] = i;
+        typedef std::map<std::string, QuantLib::Size, ObjectHandler::my_iless> FirstItem;
+        FirstItem firstItem;
+        for (QuantLib::Size i=0; i<keys.size(); ++i) {
+            for (QuantLib::Size j=0; j<keys[i].size(); ++j) {
+                if (keys[i][j].empty())
+                    continue;
+                std::pair<FirstItem::iterator, bool> k =
+                    firstItem.insert(std::make_pair(keys[i][j], i));
+                if (!k.second) {
+                    QuantLib::Size a = root(parent, i),
+                                   b = root(parent, k.first->second);
+                    // the root is the lowest item of the group
+                    if (a < b)
+                        parent[b] = a;
+                    else
+                        parent[a] = b;
+                }
+            }
+        }
+
+        std::vector<std::vector<QuantLib::Size> > groups;
+        std::vector<QuantLib::Size> groupOfRoot(keys.size(), keys.size());
+        for (QuantLib::Size i=0; i<keys.size(); ++i) {
+            QuantLib::Size r = root(parent, i);
+            if (groupOfRoot[r] == keys.size()) {
+                groupOfRoot[r] = groups.size();
+                groups.push_back(std::vector<QuantLib::Size>());
+            }
+            groups[groupOfRoot[r]].push_back(i);
+        }
+        return groups;
+    }
+
+    std::vector<std::string> objectPrecedents(const std::string& objectId,
+                                              const ObjectHandler::Object& object) {
+        std::vector<std::string> result =
+            ObjectHandler::Repository::instance().precedentIDs(objectId);
+        if (const Handle* handle = dynamic_cast<const Handle*>(&object))
+            result.push_back(handle->currentLink());
+        return result;
+    }
+
+    void collectPrecedents(const std::string& objectId,
+                           std::set<const ObjectHandler::Object*>& objects) {
+        std::vector<std::string> pending(1, objectId);
+        while (!pending.empty()) {
+            std::string current = pending.back();
+            pending.pop_back();
+            boost::shared_ptr<ObjectHandler::Object> object = retrieve(current);
+            if (!object || !objects.insert(object.get()).second)
+                continue;
+            std::vector<std::string> next = objectPrecedents(current, *object);
+            pending.insert(pending.end(), next.begin(), next.end());
+        }
+    }
+
+    void calculateLazyObject(const ObjectHandler::Object* object) {
+        try {
+            boost::shared_ptr<QuantLib::LazyObject> lazy;
+            if (const TermStructure* termStructure =
+                    dynamic_cast<const TermStructure*>(object)) {
+                boost::shared_ptr<QuantLib::TermStructure> ts;
+                termStructure->getLibraryObject(ts);
+                lazy = boost::dynamic_pointer_cast<QuantLib::LazyObject>(ts);
+                if (!lazy) {
+                    if (boost::shared_ptr<QuantLib::YieldTermStructure> yts =
+                            boost::dynamic_pointer_cast<QuantLib::YieldTermStructure>(ts))
+                        yts->discount(0.0, true);
+                }
+            } else if (const Quote* quote = dynamic_cast<const Quote*>(object)) {
+                boost::shared_ptr<QuantLib::Quote> q;
+                quote->getLibraryObject(q);
+                lazy = boost::dynamic_pointer_cast<QuantLib::LazyObject>(q);
+            }
+            if (lazy)
+                LazyCalculation::run(*lazy);
+        } catch (std::exception&) {}
+    }
+
+    void calculateLazyObject(const boost::shared_ptr<QuantLib::Observable>& object) {
+        try {
+            if (boost::shared_ptr<QuantLib::LazyObject> lazy =
+                    boost::dynamic_pointer_cast<QuantLib::LazyObject>(object))
+                LazyCalculation::run(*lazy);
+        } catch (std::exception&) {}
+    }
+
+}
@@ -0,0 +1,187 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Minimal support for running independent tasks on worker threads
+*/
+
+#ifndef qla_parallel_hpp
+#define qla_parallel_hpp
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/ref.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ObjectHandler {
+    class Object;
+}
+
+namespace QuantLib {
+    class Observable;
+}
+
+namespace QuantLibAddin {
+
+    //! Number of worker threads to use for the requested value.
+    /*! Zero means one thread per hardware thread. */
+    QuantLib::Size workerThreads(QuantLib::Size requested);
+
+    //! Partition items so that items sharing a key end up in the same group.
+    /*! keys[i] holds the IDs of the objects which item i modifies while it
+        is processed, e.g. a pricing engine or a curve state; empty IDs are
+        ignored and IDs are compared as ObjectHandler IDs, i.e. ignoring
+        case.  Sharing is transitive: if items 0 and 1 share a key and
+        items 1 and 2 share another one, all three are grouped together.
+        Groups are listed in order of their first item and each group lists
+        its items in their original order, so that processing the groups
+        concurrently and each group serially is safe and deterministic.
+    */
+    std::vector<std::vector<QuantLib::Size> > groupBySharedKeys(
+                        const std::vector<std::vector<std::string> >& keys);
+
+    //! IDs of the objects on which the given object directly depends.
+    /*! These are its precedents in the Repository and, for a handle, the
+        object it is currently linked to.
+    */
+    std::vector<std::string> objectPrecedents(const std::string& objectId,
+                                              const ObjectHandler::Object& object);
+
+    //! Collect the given object and all the objects it depends on.
+    /*! Precedents are followed transitively as returned by
+        objectPrecedents(); objects already in the set are not visited
+        again and IDs of missing objects are ignored.
+    */
+    void collectPrecedents(const std::string& objectId,
+                           std::set<const ObjectHandler::Object*>& objects);
+
+    //! Calculate the lazy term structure or quote held by the given object.
+    /*! Lazy term structures, such as bootstrapped curves or SABR swaption
+        volatility cubes, and lazy quotes are calculated when first queried:
+        doing so on the calling thread before a parallel phase leaves them
+        only read by the worker threads.  Objects already up to date are not
+        calculated again, and other objects, e.g. instruments, are left
+        alone.  Errors are ignored here and reported by the objects
+        depending on the failed one.
+    */
+    void calculateLazyObject(const ObjectHandler::Object* object);
+
+    //! Calculate the given library object if it is lazy.
+    /*! For objects not held in the Repository, e.g. the volatilities held
+        by a coupon pricer.  Errors are ignored as above.
+    */
+    void calculateLazyObject(const boost::shared_ptr<QuantLib::Observable>& object);
+
+    //! Wall-clock stopwatch.
+    /*! boost::timer measures the CPU time of the process, which overstates
+        the elapsed time of work spread over several threads.
+    */
+    class WallTimer {
+      public:
+        WallTimer() { restart(); }
+        void restart() {
+            start_ = boost::posix_time::microsec_clock::universal_time();
+        }
+        //! elapsed time in seconds
+        QuantLib::Real elapsed() const {
+            return (boost::posix_time::microsec_clock::universal_time()
+                    - start_).total_microseconds() * 1.0e-6;
+        }
+      private:
+        boost::posix_time::ptime start_;
+    };
+
+    namespace detail {
+
+        template <class F>
+        class ParallelLoop {
+          public:
+            ParallelLoop(QuantLib::Size size, F& f)
+            : size_(size), next_(0), failed_(false), f_(f) {}
+            void operator()() {
+                for (;;) {
+                    QuantLib::Size i = next_.fetch_add(1);
+                    if (i >= size_ || failed_.load())
+                        return;
+                    try {
+                        f_(i);
+                    } catch (std::exception& e) {
+                        fail(e.what());
+                    } catch (...) {
+                        fail("unknown error");
+                    }
+                }
+            }
+            bool failed() const { return failed_.load(); }
+            const std::string& error() const { return error_; }
+          private:
+            void fail(const std::string& error) {
+                boost::mutex::scoped_lock lock(mutex_);
+                if (!failed_.load()) {
+                    error_ = error;
+                    failed_.store(true);
+                }
+            }
+            QuantLib::Size size_;
+            boost::atomic<QuantLib::Size> next_;
+            boost::atomic<bool> failed_;
+            boost::mutex mutex_;
+            std::string error_;
+            F& f_;
+        };
+
+    }
+
+    //! Call f(i) for each i in [0, size) using up to the given number of threads.
+    /*! f must be safe to call concurrently for distinct indices.  The
+        calling thread takes part in the loop, so that with a single thread
+        no worker is started at all.  Indices are handed out dynamically;
+        callers needing deterministic results should write the result for
+        index i into preallocated storage and reduce it afterwards.  If f
+        throws, no further index is started and the first error is
+        rethrown once all threads have joined.
+    */
+    template <class F>
+    void parallelFor(QuantLib::Size size, QuantLib::Size threads, F& f) {
+        threads = std::min(workerThreads(threads), size);
+        detail::ParallelLoop<F> loop(size, f);
+        if (threads <= 1) {
+            loop();
+        } else {
+            boost::thread_group workers;
+            for (QuantLib::Size t=1; t<threads; ++t)
+                workers.create_thread(boost::ref(loop));
+            loop();
+            workers.join_all();
+        }
+        QL_REQUIRE(!loop.failed(), loop.error());
+    }
+
+}
+
+#endif
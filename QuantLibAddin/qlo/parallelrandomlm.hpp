@@ -0,0 +1,311 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Monte Carlo default loss model simulating on several threads
+*/
+
+#ifndef qla_parallelrandomlm_hpp
+#define qla_parallelrandomlm_hpp
+
+#include <qlo/mathf.hpp>
+#include <qlo/parallel.hpp>
+#include <qlo/randomsequencegenerator.hpp>
+
+#include <ql/experimental/credit/basket.hpp>
+#include <ql/experimental/credit/defaultlossmodel.hpp>
+#include <ql/experimental/credit/defaultprobabilitylatentmodel.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <ql/math/randomnumbers/seedgenerator.hpp>
+
+#include <boost/thread/mutex.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace QuantLibAddin {
+
+    namespace detail {
+
+        // Maps the uniforms drawn for a path to the latent variables of
+        // the names through the copula of the model.
+        template <class CopulaPolicy>
+        class LatentSampler {
+          public:
+            explicit LatentSampler(
+                        const QuantLib::DefaultLatentModel<CopulaPolicy>& model)
+            : model_(model) {}
+            void thresholds(const std::vector<QuantLib::Real>& probabilities,
+                            std::vector<QuantLib::Real>& thresholds) const {
+                for (QuantLib::Size i=0; i<probabilities.size(); ++i) {
+                    QuantLib::Probability p = probabilities[i];
+                    if (p <= 0.0)
+                        thresholds[i] = -QL_MAX_REAL;
+                    else if (p >= 1.0)
+                        thresholds[i] = QL_MAX_REAL;
+                    else
+                        thresholds[i] = model_.inverseCumulativeY(p, i);
+                }
+            }
+            void operator()(const std::vector<QuantLib::Real>& uniforms,
+                            std::vector<QuantLib::Real>&,
+                            std::vector<QuantLib::Real>& latent) const {
+                std::vector<QuantLib::Real> factors =
+                    model_.copula().allFactorCumulInverter(uniforms);
+                for (QuantLib::Size i=0; i<latent.size(); ++i)
+                    latent[i] = model_.latentVarValue(factors, i);
+            }
+          private:
+            const QuantLib::DefaultLatentModel<CopulaPolicy>& model_;
+        };
+
+        // In the Gaussian copula the factors and the latent variables are
+        // all standard normal, so that the uniforms of a path and the
+        // default thresholds are inverted in a single batch each, and the
+        // loadings are read from contiguous storage.
+        template <>
+        class LatentSampler<QuantLib::GaussianCopulaPolicy> {
+          public:
+            explicit LatentSampler(
+                const QuantLib::DefaultLatentModel<QuantLib::GaussianCopulaPolicy>& model)
+            : factors_(model.numFactors()), names_(model.size()),
+              weights_(factors_*names_), idiosyncratic_(names_) {
+                const std::vector<std::vector<QuantLib::Real> >& weights =
+                    model.factorWeights();
+                for (QuantLib::Size i=0; i<names_; ++i) {
+                    QuantLib::Real sum = 0.0;
+                    for (QuantLib::Size k=0; k<factors_; ++k) {
+                        weights_[i*factors_+k] = weights[i][k];
+                        sum += weights[i][k]*weights[i][k];
+                    }
+                    idiosyncratic_[i] = std::sqrt(1.0 - sum);
+                }
+            }
+            void thresholds(const std::vector<QuantLib::Real>& probabilities,
+                            std::vector<QuantLib::Real>& thresholds) const {
+                std::vector<QuantLib::Real> inner(probabilities);
+                for (QuantLib::Size i=0; i<inner.size(); ++i) {
+                    if (inner[i] <= 0.0 || inner[i] >= 1.0)
+                        inner[i] = 0.5;
+                }
+                normSInv(&inner[0], &thresholds[0], inner.size());
+                for (QuantLib::Size i=0; i<inner.size(); ++i) {
+                    if (probabilities[i] <= 0.0)
+                        thresholds[i] = -QL_MAX_REAL;
+                    else if (probabilities[i] >= 1.0)
+                        thresholds[i] = QL_MAX_REAL;
+                }
+            }
+            void operator()(const std::vector<QuantLib::Real>& uniforms,
+                            std::vector<QuantLib::Real>& normals,
+                            std::vector<QuantLib::Real>& latent) const {
+                normals.resize(uniforms.size());
+                normSInv(&uniforms[0], &normals[0], uniforms.size());
+                const QuantLib::Real* w = &weights_[0];
+                for (QuantLib::Size i=0; i<names_; ++i, w+=factors_) {
+                    QuantLib::Real y = 0.0;
+                    for (QuantLib::Size k=0; k<factors_; ++k)
+                        y += w[k]*normals[k];
+                    latent[i] = y + idiosyncratic_[i]*normals[factors_+i];
+                }
+            }
+          private:
+            QuantLib::Size factors_, names_;
+            std::vector<QuantLib::Real> weights_, idiosyncratic_;
+        };
+
+    }
+
+    //! Monte Carlo default loss model simulating on several threads.
+    /*! The defaults up to each requested date are sampled from the latent
+        model in a single step: a name defaults on a path when its latent
+        variable falls below the inverse of its default probability.  Paths
+        are simulated in blocks of fixed size, each drawing from its own
+        stream of the given seed (see streamSeed), so that the simulated
+        losses do not depend on the number of threads.  A null seed is
+        replaced on construction by one drawn from QuantLib's
+        SeedGenerator, which is not thread-safe, so that the streams of the
+        blocks still differ and are seeded on the worker threads without
+        calling it.
+
+        The sorted tranche losses simulated for a date are kept and shared
+        by expectedTrancheLoss, percentile and expectedShortfall.  They are
+        simulated again when the default probabilities, notionals or tranche
+        of the basket have changed since.  Other queries are not available
+        for this model.
+    */
+    template <class CopulaPolicy>
+    class ParallelRandomDefaultLM : public QuantLib::DefaultLossModel {
+      public:
+        ParallelRandomDefaultLM(
+            const boost::shared_ptr<QuantLib::DefaultLatentModel<CopulaPolicy> >& model,
+            const std::vector<QuantLib::Real>& recoveries,
+            QuantLib::Size nSims,
+            QuantLib::BigNatural seed,
+            QuantLib::Size threads)
+        : model_(model), recoveries_(recoveries), nSims_(nSims),
+          seed_(seed != 0 ? seed : QuantLib::SeedGenerator::instance().get()),
+          threads_(threads) {
+            QL_REQUIRE(nSims_ > 0, "at least one simulation is required");
+            QL_REQUIRE(recoveries_.size() == model_->size(),
+                       "number of recoveries (" << recoveries_.size()
+                       << ") does not match the model size ("
+                       << model_->size() << ")");
+        }
+        QuantLib::Real expectedTrancheLoss(const QuantLib::Date& d) const {
+            boost::shared_ptr<Losses> losses = simulatedLosses(d);
+            QuantLib::Real sum = 0.0;
+            for (QuantLib::Size j=0; j<nSims_; ++j)
+                sum += losses->sorted[j];
+            return sum / nSims_;
+        }
+        QuantLib::Real percentile(const QuantLib::Date& d,
+                                  QuantLib::Real percentile) const {
+            boost::shared_ptr<Losses> losses = simulatedLosses(d);
+            return losses->sorted[position(percentile)];
+        }
+        QuantLib::Real expectedShortfall(const QuantLib::Date& d,
+                                         QuantLib::Real percentile) const {
+            boost::shared_ptr<Losses> losses = simulatedLosses(d);
+            QuantLib::Size first = position(percentile);
+            QuantLib::Real sum = 0.0;
+            for (QuantLib::Size j=first; j<nSims_; ++j)
+                sum += losses->sorted[j];
+            return sum / (nSims_ - first);
+        }
+      private:
+        enum { blockSize = 1024 };
+
+        // simulated tranche losses and the inputs they were simulated from
+        struct Losses {
+            std::vector<QuantLib::Real> probabilities, notionals;
+            QuantLib::Real attachment, detachment;
+            std::vector<QuantLib::Real> thresholds;
+            std::vector<QuantLib::Real> sorted;
+        };
+
+        class BlockSimulation {
+          public:
+            BlockSimulation(const detail::LatentSampler<CopulaPolicy>& sampler,
+                            QuantLib::Size dimension,
+                            const std::vector<QuantLib::Real>& lossGivenDefault,
+                            const Losses& inputs,
+                            QuantLib::BigNatural seed,
+                            std::vector<QuantLib::Real>& losses)
+            : sampler_(sampler), dimension_(dimension),
+              lossGivenDefault_(lossGivenDefault), inputs_(inputs),
+              seed_(seed), losses_(losses) {}
+            void operator()(QuantLib::Size block) {
+                QuantLib::MersenneTwisterUniformRng rng(
+                    streamSeed(seed_, static_cast<long>(block)));
+                std::vector<QuantLib::Real> uniforms(dimension_), workspace;
+                std::vector<QuantLib::Real> latent(lossGivenDefault_.size());
+                QuantLib::Size end =
+                    std::min<QuantLib::Size>((block+1)*blockSize, losses_.size());
+                for (QuantLib::Size j=block*blockSize; j<end; ++j) {
+                    for (QuantLib::Size k=0; k<dimension_; ++k)
+                        uniforms[k] = rng.nextReal();
+                    sampler_(uniforms, workspace, latent);
+                    QuantLib::Real loss = 0.0;
+                    for (QuantLib::Size i=0; i<latent.size(); ++i) {
+                        if (latent[i] <= inputs_.thresholds[i])
+                            loss += lossGivenDefault_[i];
+                    }
+                    losses_[j] = std::min(std::max(loss - inputs_.attachment, 0.0),
+                                          inputs_.detachment - inputs_.attachment);
+                }
+            }
+          private:
+            const detail::LatentSampler<CopulaPolicy>& sampler_;
+            QuantLib::Size dimension_;
+            const std::vector<QuantLib::Real>& lossGivenDefault_;
+            const Losses& inputs_;
+            QuantLib::BigNatural seed_;
+            std::vector<QuantLib::Real>& losses_;
+        };
+
+        QuantLib::Size position(QuantLib::Real percentile) const {
+            QL_REQUIRE(percentile >= 0.0 && percentile <= 1.0,
+                       "percentile (" << percentile << ") out of range");
+            return std::min<QuantLib::Size>(
+                static_cast<QuantLib::Size>(percentile * nSims_), nSims_ - 1);
+        }
+
+        boost::shared_ptr<Losses> simulatedLosses(const QuantLib::Date& d) const {
+            boost::shared_ptr<Losses> current(new Losses);
+            current->probabilities = basket_->remainingProbabilities(d);
+            current->notionals = basket_->remainingNotionals(d);
+            current->attachment = basket_->remainingAttachmentAmount();
+            current->detachment = basket_->remainingDetachmentAmount();
+            QL_REQUIRE(current->probabilities.size() == model_->size(),
+                       "number of live names (" << current->probabilities.size()
+                       << ") does not match the model size ("
+                       << model_->size() << ")");
+
+            // concurrent queries for the same date wait for one simulation
+            boost::mutex::scoped_lock lock(mutex_);
+            typename std::map<QuantLib::Date, boost::shared_ptr<Losses> >::iterator
+                cached = losses_.find(d);
+            if (cached != losses_.end() &&
+                cached->second->probabilities == current->probabilities &&
+                cached->second->notionals == current->notionals &&
+                cached->second->attachment == current->attachment &&
+                cached->second->detachment == current->detachment)
+                return cached->second;
+
+            // the thresholds only depend on the default probabilities
+            detail::LatentSampler<CopulaPolicy> sampler(*model_);
+            if (cached != losses_.end() &&
+                cached->second->probabilities == current->probabilities) {
+                current->thresholds = cached->second->thresholds;
+            } else {
+                current->thresholds.resize(model_->size());
+                sampler.thresholds(current->probabilities, current->thresholds);
+            }
+            std::vector<QuantLib::Real> lossGivenDefault(model_->size());
+            for (QuantLib::Size i=0; i<model_->size(); ++i)
+                lossGivenDefault[i] =
+                    current->notionals[i] * (1.0 - recoveries_[i]);
+            current->sorted.resize(nSims_);
+            BlockSimulation simulation(sampler, model_->numTotalFactors(),
+                                       lossGivenDefault, *current, seed_,
+                                       current->sorted);
+            parallelFor((nSims_ + blockSize - 1) / blockSize, threads_, simulation);
+            std::sort(current->sorted.begin(), current->sorted.end());
+            losses_[d] = current;
+            return current;
+        }
+
+        void resetModel() {
+            boost::mutex::scoped_lock lock(mutex_);
+            losses_.clear();
+        }
+
+        boost::shared_ptr<QuantLib::DefaultLatentModel<CopulaPolicy> > model_;
+        std::vector<QuantLib::Real> recoveries_;
+        QuantLib::Size nSims_;
+        QuantLib::BigNatural seed_;
+        QuantLib::Size threads_;
+        mutable boost::mutex mutex_;
+        mutable std::map<QuantLib::Date, boost::shared_ptr<Losses> > losses_;
+    };
+
+}
+
+#endif
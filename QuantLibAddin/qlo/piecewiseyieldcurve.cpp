@@ -24,15 +24,36 @@
 #endif
 
 #include <qlo/piecewiseyieldcurve.hpp>
+#include <qlo/incrementalbootstrap.hpp>
+#include <qlo/parallel.hpp>
 #include <qlo/enumerations/factories/termstructuresfactory.hpp>
+#include <oh/repository.hpp>
 
 #include <ql/termstructures/yield/piecewiseyieldcurve.hpp>
 #include <ql/math/interpolations/forwardflatinterpolation.hpp>
 #include <ql/math/interpolations/backwardflatinterpolation.hpp>
 #include <ql/math/interpolations/mixedinterpolation.hpp>
 
+#include <map>
+#include <set>
+
 namespace QuantLibAddin {
 
+    namespace Call {
+
+    // Build a curve with an incremental bootstrap, defined below
+    boost::shared_ptr<QuantLib::YieldTermStructure> incrementalCurve(
+            InterpolatedYieldCurvePair tokenPair,
+            QuantLib::Natural nDays,
+            const QuantLib::Calendar& calendar,
+            const std::vector<boost::shared_ptr<QuantLib::RateHelper> >& qlrhs,
+            const QuantLib::DayCounter& dayCounter,
+            const std::vector<QuantLib::Handle<QuantLib::Quote> >& jumps,
+            const std::vector<QuantLib::Date>& jumpDates,
+            const boost::shared_ptr<BootstrapStatistics>& statistics);
+
+    }
+
     // Constructor
 
     PiecewiseYieldCurve::PiecewiseYieldCurve(
@@ -81,9 +102,32 @@ namespace QuantLibAddin {
             const std::vector<QuantLib::Date>& jumpDates,
             const std::string& traitsID,
             const std::string& interpolatorID,
+            bool incremental,
             bool permanent)
     : YieldTermStructure(properties, permanent)
     {
+        // convert input strings to enumerated datatypes
+        InterpolatedYieldCurve::Traits traits =
+            ObjectHandler::Create<InterpolatedYieldCurve::Traits>()(traitsID);
+        InterpolatedYieldCurve::Interpolator interpolator =
+            ObjectHandler::Create<InterpolatedYieldCurve::Interpolator>()(interpolatorID);
+
+        pair_ = InterpolatedYieldCurvePair(traits, interpolator);
+
+        if (incremental) {
+            statistics_ = boost::shared_ptr<BootstrapStatistics>(
+                                                    new BootstrapStatistics);
+            libraryObject_ = Call::incrementalCurve(pair_,
+                                                    nDays,
+                                                    calendar,
+                                                    qlrhs,
+                                                    dayCounter,
+                                                    jumps,
+                                                    jumpDates,
+                                                    statistics_);
+            return;
+        }
+
         libraryObject_ = ObjectHandler::Create<boost::shared_ptr<
             QuantLib::YieldTermStructure> >()(traitsID,
                                               interpolatorID,
@@ -95,14 +139,6 @@ namespace QuantLibAddin {
                                               jumpDates,
                                               QuantLib::MixedInterpolation::ShareRanges,
                                               0);
-
-        // convert input strings to enumerated datatypes
-        InterpolatedYieldCurve::Traits traits =
-            ObjectHandler::Create<InterpolatedYieldCurve::Traits>()(traitsID);
-        InterpolatedYieldCurve::Interpolator interpolator =
-            ObjectHandler::Create<InterpolatedYieldCurve::Interpolator>()(interpolatorID);
-
-        pair_ = InterpolatedYieldCurvePair(traits, interpolator);
     }
 
     // Before implementing the member functions it is necessary to provide some logic to wrap
@@ -129,9 +165,97 @@ namespace QuantLibAddin {
         virtual const std::vector<QuantLib::Time>& jumpTimes(const QuantLib::Extrapolator *extrapolator) const = 0;
         virtual const std::vector<QuantLib::Date>& jumpDates(const QuantLib::Extrapolator *extrapolator) const = 0;
 
+        virtual boost::shared_ptr<QuantLib::YieldTermStructure> incrementalCurve(
+            QuantLib::Natural nDays,
+            const QuantLib::Calendar& calendar,
+            const std::vector<boost::shared_ptr<QuantLib::RateHelper> >& qlrhs,
+            const QuantLib::DayCounter& dayCounter,
+            const std::vector<QuantLib::Handle<QuantLib::Quote> >& jumps,
+            const std::vector<QuantLib::Date>& jumpDates,
+            const boost::shared_ptr<BootstrapStatistics>& statistics) const = 0;
+
+        virtual boost::shared_ptr<QuantLib::YieldTermStructure> incrementalCurve(
+            const QuantLib::Date& referenceDate,
+            const std::vector<boost::shared_ptr<QuantLib::RateHelper> >& qlrhs,
+            const QuantLib::DayCounter& dayCounter,
+            QuantLib::Real accuracy) const = 0;
+
         virtual ~CallerBase() {}
     };
 
+    // PiecewiseYieldCurve<Traits, Interpolator, IncrementalBootstrap> is only
+    // instantiated for local interpolators: with a global one every pillar
+    // depends on all the others, so that there is nothing to gain, and the
+    // parameters of the interpolator would not be available here anyway.
+
+    template <class Traits, class Interpolator, bool Global = Interpolator::global>
+    class IncrementalCaller {
+    public:
+        typedef QuantLib::PiecewiseYieldCurve<Traits, Interpolator,
+                                              IncrementalBootstrap> CurveClass;
+
+        static const CurveClass *get(const QuantLib::Extrapolator *extrapolator) {
+            return dynamic_cast<const CurveClass*>(extrapolator);
+        }
+
+        static boost::shared_ptr<QuantLib::YieldTermStructure> create(
+            QuantLib::Natural nDays,
+            const QuantLib::Calendar& calendar,
+            const std::vector<boost::shared_ptr<QuantLib::RateHelper> >& qlrhs,
+            const QuantLib::DayCounter& dayCounter,
+            const std::vector<QuantLib::Handle<QuantLib::Quote> >& jumps,
+            const std::vector<QuantLib::Date>& jumpDates,
+            const boost::shared_ptr<BootstrapStatistics>& statistics) {
+            return boost::shared_ptr<QuantLib::YieldTermStructure>(new
+                CurveClass(nDays, calendar, qlrhs, dayCounter, jumps, jumpDates,
+                           Interpolator(),
+                           IncrementalBootstrap<CurveClass>(statistics)));
+        }
+
+        static boost::shared_ptr<QuantLib::YieldTermStructure> create(
+            const QuantLib::Date& referenceDate,
+            const std::vector<boost::shared_ptr<QuantLib::RateHelper> >& qlrhs,
+            const QuantLib::DayCounter& dayCounter,
+            QuantLib::Real accuracy) {
+            return boost::shared_ptr<QuantLib::YieldTermStructure>(new
+                CurveClass(referenceDate, qlrhs, dayCounter,
+                           std::vector<QuantLib::Handle<QuantLib::Quote> >(),
+                           std::vector<QuantLib::Date>(),
+                           Interpolator(),
+                           IncrementalBootstrap<CurveClass>(
+                               boost::shared_ptr<BootstrapStatistics>(), accuracy)));
+        }
+    };
+
+    template <class Traits, class Interpolator>
+    class IncrementalCaller<Traits, Interpolator, true> {
+    public:
+        typedef QuantLib::PiecewiseYieldCurve<Traits, Interpolator> CurveClass;
+
+        static const CurveClass *get(const QuantLib::Extrapolator *) {
+            return 0;
+        }
+
+        static boost::shared_ptr<QuantLib::YieldTermStructure> create(
+            QuantLib::Natural,
+            const QuantLib::Calendar&,
+            const std::vector<boost::shared_ptr<QuantLib::RateHelper> >&,
+            const QuantLib::DayCounter&,
+            const std::vector<QuantLib::Handle<QuantLib::Quote> >&,
+            const std::vector<QuantLib::Date>&,
+            const boost::shared_ptr<BootstrapStatistics>&) {
+            OH_FAIL("incremental bootstrap not available for global interpolators");
+        }
+
+        static boost::shared_ptr<QuantLib::YieldTermStructure> create(
+            const QuantLib::Date&,
+            const std::vector<boost::shared_ptr<QuantLib::RateHelper> >&,
+            const QuantLib::DayCounter&,
+            QuantLib::Real) {
+            OH_FAIL("incremental bootstrap not available for global interpolators");
+        }
+    };
+
     // Concrete derived class to wrap member functions of PiecewiseYieldCurve<Traits, Interpolator>.
     // Given a pointer to QuantLib::Extrapolator, this class downcasts to
     // PiecewiseYieldCurve<Traits, Interpolator>* and calls the given member function.
@@ -140,6 +264,7 @@ namespace QuantLibAddin {
     class Caller : public CallerBase {
 
         typedef QuantLib::PiecewiseYieldCurve<Traits, Interpolator> CurveClass;
+        typedef IncrementalCaller<Traits, Interpolator> Incremental;
 
         const CurveClass *get(const QuantLib::Extrapolator *extrapolator) const {
 
@@ -150,14 +275,20 @@ namespace QuantLibAddin {
         }
 
         const std::vector<QuantLib::Time>& times(const QuantLib::Extrapolator *extrapolator) const {
+            if (const typename Incremental::CurveClass *curve = Incremental::get(extrapolator))
+                return curve->times();
             return get(extrapolator)->times();
         }
 
         const std::vector<QuantLib::Date>& dates(const QuantLib::Extrapolator *extrapolator) const {
+            if (const typename Incremental::CurveClass *curve = Incremental::get(extrapolator))
+                return curve->dates();
             return get(extrapolator)->dates();
         }
 
         const std::vector<QuantLib::Real>& data(const QuantLib::Extrapolator *extrapolator) const {
+            if (const typename Incremental::CurveClass *curve = Incremental::get(extrapolator))
+                return curve->data();
             return get(extrapolator)->data();
         }
 
@@ -170,13 +301,37 @@ namespace QuantLibAddin {
         //}
 
         const std::vector<QuantLib::Time>& jumpTimes(const QuantLib::Extrapolator *extrapolator) const {
+            if (const typename Incremental::CurveClass *curve = Incremental::get(extrapolator))
+                return curve->jumpTimes();
             return get(extrapolator)->jumpTimes();
         }
 
         const std::vector<QuantLib::Date>& jumpDates(const QuantLib::Extrapolator *extrapolator) const {
+            if (const typename Incremental::CurveClass *curve = Incremental::get(extrapolator))
+                return curve->jumpDates();
             return get(extrapolator)->jumpDates();
         }
 
+        boost::shared_ptr<QuantLib::YieldTermStructure> incrementalCurve(
+            QuantLib::Natural nDays,
+            const QuantLib::Calendar& calendar,
+            const std::vector<boost::shared_ptr<QuantLib::RateHelper> >& qlrhs,
+            const QuantLib::DayCounter& dayCounter,
+            const std::vector<QuantLib::Handle<QuantLib::Quote> >& jumps,
+            const std::vector<QuantLib::Date>& jumpDates,
+            const boost::shared_ptr<BootstrapStatistics>& statistics) const {
+            return Incremental::create(nDays, calendar, qlrhs, dayCounter,
+                                       jumps, jumpDates, statistics);
+        }
+
+        boost::shared_ptr<QuantLib::YieldTermStructure> incrementalCurve(
+            const QuantLib::Date& referenceDate,
+            const std::vector<boost::shared_ptr<QuantLib::RateHelper> >& qlrhs,
+            const QuantLib::DayCounter& dayCounter,
+            QuantLib::Real accuracy) const {
+            return Incremental::create(referenceDate, qlrhs, dayCounter, accuracy);
+        }
+
     };
 
     // Class CallerFactory stores a map of pointers to Caller objects
@@ -280,8 +435,37 @@ namespace QuantLibAddin {
         return callerFactory_;
     }
 
+    boost::shared_ptr<QuantLib::YieldTermStructure> incrementalCurve(
+            InterpolatedYieldCurvePair tokenPair,
+            QuantLib::Natural nDays,
+            const QuantLib::Calendar& calendar,
+            const std::vector<boost::shared_ptr<QuantLib::RateHelper> >& qlrhs,
+            const QuantLib::DayCounter& dayCounter,
+            const std::vector<QuantLib::Handle<QuantLib::Quote> >& jumps,
+            const std::vector<QuantLib::Date>& jumpDates,
+            const boost::shared_ptr<BootstrapStatistics>& statistics) {
+        return callerFactory().getCaller(tokenPair)->incrementalCurve(
+            nDays, calendar, qlrhs, dayCounter, jumps, jumpDates, statistics);
+    }
+
     } // namespace Call
 
+    boost::shared_ptr<QuantLib::YieldTermStructure> fixedReferenceDateCurve(
+            const std::string& traitsID,
+            const std::string& interpolatorID,
+            const QuantLib::Date& referenceDate,
+            const std::vector<boost::shared_ptr<QuantLib::RateHelper> >& qlrhs,
+            const QuantLib::DayCounter& dayCounter,
+            QuantLib::Real accuracy) {
+        InterpolatedYieldCurve::Traits traits =
+            ObjectHandler::Create<InterpolatedYieldCurve::Traits>()(traitsID);
+        InterpolatedYieldCurve::Interpolator interpolator =
+            ObjectHandler::Create<InterpolatedYieldCurve::Interpolator>()(interpolatorID);
+        return Call::callerFactory().getCaller(
+            InterpolatedYieldCurvePair(traits, interpolator))->incrementalCurve(
+                referenceDate, qlrhs, dayCounter, accuracy);
+    }
+
     // QuantLibAddin wrappers for member functions of QuantLib class
     // PiecewiseYieldCurve<Traits, Interpolator>. Invocation of the member function is
     // passed off to the CallerFactory which hides the details of the template class.
@@ -301,13 +485,27 @@ Call::callerFactory().getCaller(pair_)->FUNC(libraryObject_.get())
         return CALL(data);
     }
 
-    //const std::vector<QuantLib::Real>& PiecewiseYieldCurve::improvements() const {
-    //    return CALL(improvements);
-    //}
+    // The statistics are updated by the bootstrap itself: retrieving the
+    // curve data first makes sure that a pending bootstrap is run.
+
+    const std::vector<QuantLib::Real>& PiecewiseYieldCurve::improvements() const {
+        OH_REQUIRE(statistics_, "curve not built with an incremental bootstrap");
+        CALL(data);
+        return statistics_->improvements;
+    }
 
-    //QuantLib::Size PiecewiseYieldCurve::iterations() const {
-    //    return CALL(iterations);
-    //}
+    QuantLib::Size PiecewiseYieldCurve::iterations() const {
+        OH_REQUIRE(statistics_, "curve not built with an incremental bootstrap");
+        CALL(data);
+        return statistics_->improvements.size();
+    }
+
+    std::vector<std::vector<ObjectHandler::property_t> >
+    PiecewiseYieldCurve::bootstrapStatistics() const {
+        OH_REQUIRE(statistics_, "curve not built with an incremental bootstrap");
+        CALL(data);
+        return QuantLibAddin::bootstrapStatistics(*statistics_);
+    }
 
     const std::vector<QuantLib::Time>& PiecewiseYieldCurve::jumpTimes() const {
         return CALL(jumpTimes);
@@ -317,4 +515,163 @@ Call::callerFactory().getCaller(pair_)->FUNC(libraryObject_.get())
         return CALL(jumpDates);
     }
 
+    namespace {
+
+        typedef std::set<const ObjectHandler::Object*> ObjectSet;
+
+        QuantLib::Size curveLevel(QuantLib::Size i,
+                                  const std::vector<std::vector<QuantLib::Size> >& dependencies,
+                                  std::vector<QuantLib::Size>& levels) {
+            if (levels[i] == QuantLib::Null<QuantLib::Size>()) {
+                QuantLib::Size level = 0;
+                for (QuantLib::Size k=0; k<dependencies[i].size(); ++k)
+                    level = std::max(level,
+                                     curveLevel(dependencies[i][k], dependencies, levels) + 1);
+                levels[i] = level;
+            }
+            return levels[i];
+        }
+
+        struct CurveBuild {
+            CurveBuild() : elapsed(0.0) {}
+            QuantLib::Real elapsed;
+            std::string error;
+        };
+
+        // Bootstraps the curves of one group in turn; distinct groups of the
+        // same level share no rate helper and can be processed concurrently.
+        class CurveGroupBuild {
+          public:
+            CurveGroupBuild(
+                const std::vector<boost::shared_ptr<QuantLib::YieldTermStructure> >& curves,
+                const std::vector<std::vector<QuantLib::Size> >& groups,
+                std::vector<CurveBuild>& builds)
+            : curves_(curves), groups_(groups), builds_(builds) {}
+            void operator()(QuantLib::Size g) {
+                for (QuantLib::Size k=0; k<groups_[g].size(); ++k) {
+                    QuantLib::Size i = groups_[g][k];
+                    WallTimer timer;
+                    try {
+                        curves_[i]->discount(0.0, true);
+                    } catch (std::exception& e) {
+                        builds_[i].error = e.what();
+                    }
+                    builds_[i].elapsed = timer.elapsed();
+                }
+            }
+          private:
+            const std::vector<boost::shared_ptr<QuantLib::YieldTermStructure> >& curves_;
+            const std::vector<std::vector<QuantLib::Size> >& groups_;
+            std::vector<CurveBuild>& builds_;
+        };
+
+    }
+
+    std::vector<std::vector<ObjectHandler::property_t> > buildCurves(
+        const std::vector<std::string>& curveIds,
+        QuantLib::Size threads) {
+
+        QL_REQUIRE(!curveIds.empty(), "no curves given");
+
+        // the dependency graph is read on the calling thread only
+        QuantLib::Size n = curveIds.size();
+        std::vector<boost::shared_ptr<QuantLib::YieldTermStructure> > curves(n);
+        std::vector<const ObjectHandler::Object*> objects(n);
+        std::map<const ObjectHandler::Object*, QuantLib::Size> index;
+        for (QuantLib::Size i=0; i<n; ++i) {
+            boost::shared_ptr<YieldTermStructure> curve;
+            ObjectHandler::Repository::instance().retrieveObject(curve, curveIds[i]);
+            curve->getLibraryObject(curves[i]);
+            objects[i] = curve.get();
+            QL_REQUIRE(index.insert(std::make_pair(objects[i], i)).second,
+                       "curve " << curveIds[i] << " given more than once");
+        }
+
+        std::vector<std::vector<QuantLib::Size> > dependencies(n);
+        // the direct precedents which were not given, e.g. the rate
+        // helpers, are modified by the bootstrap and key the groups below
+        std::set<std::string, ObjectHandler::my_iless> givenIds(
+                                            curveIds.begin(), curveIds.end());
+        std::vector<std::vector<std::string> > direct(n);
+        std::vector<ObjectSet> unlisted(n);
+        for (QuantLib::Size i=0; i<n; ++i) {
+            std::vector<std::string> ids = objectPrecedents(curveIds[i], *objects[i]);
+            ObjectSet closure;
+            for (QuantLib::Size k=0; k<ids.size(); ++k) {
+                if (givenIds.find(ids[k]) == givenIds.end())
+                    direct[i].push_back(ids[k]);
+                collectPrecedents(ids[k], closure);
+            }
+            QL_REQUIRE(closure.find(objects[i]) == closure.end(),
+                       "curve " << curveIds[i] << " depends on itself");
+            for (ObjectSet::const_iterator j=closure.begin(); j!=closure.end(); ++j) {
+                std::map<const ObjectHandler::Object*, QuantLib::Size>::const_iterator
+                    k = index.find(*j);
+                if (k != index.end())
+                    dependencies[i].push_back(k->second);
+                else
+                    unlisted[i].insert(*j);
+            }
+        }
+
+        // closures are transitive, so a cycle would have been caught above
+        std::vector<QuantLib::Size> levels(n, QuantLib::Null<QuantLib::Size>());
+        QuantLib::Size depth = 0;
+        for (QuantLib::Size i=0; i<n; ++i)
+            depth = std::max(depth, curveLevel(i, dependencies, levels) + 1);
+
+        std::vector<CurveBuild> builds(n);
+        ObjectSet calculated;
+        for (QuantLib::Size level=0; level<depth; ++level) {
+            // Term structures which were not given but which the curves of
+            // this level depend on, e.g. an OIS discount curve, may be
+            // reached from several groups: they are calculated here, on the
+            // calling thread, and only read during the parallel phase.
+            // The given curves they depend on belong to lower levels.
+            for (QuantLib::Size i=0; i<n; ++i) {
+                if (levels[i] != level)
+                    continue;
+                for (ObjectSet::const_iterator j=unlisted[i].begin();
+                     j!=unlisted[i].end(); ++j) {
+                    if (calculated.insert(*j).second)
+                        calculateLazyObject(*j);
+                }
+            }
+
+            std::vector<QuantLib::Size> curvesOfLevel;
+            std::vector<std::vector<std::string> > keys;
+            for (QuantLib::Size i=0; i<n; ++i) {
+                if (levels[i] != level)
+                    continue;
+                curvesOfLevel.push_back(i);
+                keys.push_back(direct[i]);
+            }
+            std::vector<std::vector<QuantLib::Size> > groups =
+                groupBySharedKeys(keys);
+            for (QuantLib::Size g=0; g<groups.size(); ++g)
+                for (QuantLib::Size k=0; k<groups[g].size(); ++k)
+                    groups[g][k] = curvesOfLevel[groups[g][k]];
+            CurveGroupBuild f(curves, groups, builds);
+            parallelFor(groups.size(), threads, f);
+        }
+
+        std::vector<std::vector<ObjectHandler::property_t> > result;
+        std::vector<ObjectHandler::property_t> headings(4);
+        headings[0] = std::string("Curve");
+        headings[1] = std::string("Level");
+        headings[2] = std::string("Elapsed");
+        headings[3] = std::string("Error");
+        result.push_back(headings);
+
+        for (QuantLib::Size i=0; i<n; ++i) {
+            std::vector<ObjectHandler::property_t> row(4);
+            row[0] = curveIds[i];
+            row[1] = static_cast<long>(levels[i]);
+            row[2] = builds[i].elapsed;
+            row[3] = builds[i].error;
+            result.push_back(row);
+        }
+        return result;
+    }
+
 }
@@ -23,9 +23,14 @@
 #define qla_piecewiseyieldcurve_hpp
 
 #include <qlo/yieldtermstructures.hpp>
+#include <oh/property.hpp>
+#include <string>
+#include <vector>
 
 namespace QuantLibAddin {
 
+    struct BootstrapStatistics;
+
     // A wrapper for QuantLib template class PiecewiseYieldCurve<Traits, Interpolator>.
     // Calls to constructor/member functions must specify values for Traits and Interpolator
     // because it is not possible to expose a template class directly to client platforms
@@ -55,6 +60,7 @@ namespace QuantLibAddin {
             const std::vector<QuantLib::Date>& jumpDates,
             const std::string& traitsID,
             const std::string& interpolatorID,
+            bool incremental,
             bool permanent);
         const std::vector<QuantLib::Time>& times() const;
 
@@ -62,9 +68,13 @@ namespace QuantLibAddin {
 
         const std::vector<QuantLib::Real>& data() const;
 
-        //const std::vector<QuantLib::Real>& improvements() const;
+        // Diagnostics of the last bootstrap, only available for
+        // curves built with an incremental bootstrap.
+        const std::vector<QuantLib::Real>& improvements() const;
+
+        QuantLib::Size iterations() const;
 
-        //QuantLib::Size iterations() const;
+        std::vector<std::vector<ObjectHandler::property_t> > bootstrapStatistics() const;
 
         InterpolatedYieldCurvePair interpolatedYieldCurvePair() const {
             return pair_;
@@ -76,9 +86,34 @@ namespace QuantLibAddin {
 
 	private:
 		InterpolatedYieldCurvePair pair_;
+        boost::shared_ptr<BootstrapStatistics> statistics_;
 
     };
 
+    // Build a curve with the given reference date and an incremental
+    // bootstrap, which only differs from the iterative one when the curve
+    // is bootstrapped again.  Only local interpolators are supported.
+    boost::shared_ptr<QuantLib::YieldTermStructure> fixedReferenceDateCurve(
+        const std::string& traitsID,
+        const std::string& interpolatorID,
+        const QuantLib::Date& referenceDate,
+        const std::vector<boost::shared_ptr<QuantLib::RateHelper> >& qlrhs,
+        const QuantLib::DayCounter& dayCounter,
+        QuantLib::Real accuracy);
+
+    // Bootstrap the given yield curves, concurrently where this is safe.
+    // Dependencies between the curves are read from the precedents
+    // recorded in the repository (following the current link of handles):
+    // a curve is bootstrapped after every given curve it depends on, and
+    // curves sharing a direct precedent such as a rate helper are
+    // bootstrapped in turn.  Term structures which were not given but are
+    // reached through the precedents of the curves are calculated on the
+    // calling thread before the curves depending on them.  Returns the
+    // level, elapsed time and error of each curve.
+    std::vector<std::vector<ObjectHandler::property_t> > buildCurves(
+        const std::vector<std::string>& curveIds,
+        QuantLib::Size threads);
+
 }
 
 #endif
@@ -0,0 +1,336 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <qlo/config.hpp>
+#endif
+#include <qlo/quotefeed.hpp>
+#include <qlo/quotes.hpp>
+
+#include <oh/repository.hpp>
+#include <ql/errors.hpp>
+
+#include <boost/bind.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <sstream>
+
+using std::string;
+using std::vector;
+using boost::shared_ptr;
+using boost::posix_time::ptime;
+using boost::posix_time::microsec_clock;
+using QuantLib::Real;
+using QuantLib::Size;
+
+namespace QuantLibAddin {
+
+    namespace {
+
+        ptime now() {
+            return microsec_clock::universal_time();
+        }
+
+        Real seconds(const boost::posix_time::time_duration& d) {
+            return d.total_microseconds() * 1.0e-6;
+        }
+
+    }
+
+    void QueueQuoteSource::push(const string& quoteId, Real value) {
+        QuoteTick tick;
+        tick.quoteId = quoteId;
+        tick.value = value;
+        tick.received = now();
+        boost::mutex::scoped_lock lock(mutex_);
+        QL_REQUIRE(!closed_, "cannot push quote " << quoteId <<
+                   ": the queue is closed");
+        pending_.push_back(tick);
+    }
+
+    void QueueQuoteSource::close() {
+        boost::mutex::scoped_lock lock(mutex_);
+        closed_ = true;
+        changed_.notify_all();
+    }
+
+    void QueueQuoteSource::interrupt() {
+        boost::mutex::scoped_lock lock(mutex_);
+        interrupted_ = true;
+        changed_.notify_all();
+    }
+
+    bool QueueQuoteSource::read(vector<QuoteTick>& ticks,
+                                const boost::posix_time::time_duration& slice) {
+        ptime deadline = now() + slice;
+        boost::mutex::scoped_lock lock(mutex_);
+        // wait for the end of the slice, so that the updates received in
+        // the meantime are applied as a single batch
+        while (!closed_ && !interrupted_) {
+            if (!changed_.timed_wait(lock, deadline))
+                break;
+        }
+        interrupted_ = false;
+        ticks.insert(ticks.end(), pending_.begin(), pending_.end());
+        pending_.clear();
+        return !closed_;
+    }
+
+    StreamQuoteSource::StreamQuoteSource(const string& fileName)
+    : fileName_(fileName), in_(fileName.c_str()), line_(0) {
+        QL_REQUIRE(in_, "cannot open quote feed " << fileName);
+    }
+
+    bool StreamQuoteSource::read(vector<QuoteTick>& ticks,
+                                 const boost::posix_time::time_duration& slice) {
+        ptime deadline = now() + slice;
+        string line;
+        while (std::getline(in_, line)) {
+            ++line_;
+            std::replace(line.begin(), line.end(), ',', ' ');
+            std::istringstream fields(line);
+            QuoteTick tick;
+            if (fields >> tick.quoteId && tick.quoteId[0] != '#') {
+                QL_REQUIRE(fields >> tick.value,
+                           fileName_ << "(" << line_ << "): "
+                           "no value for quote " << tick.quoteId);
+                tick.received = now();
+                ticks.push_back(tick);
+            }
+            if (now() >= deadline)
+                return true;
+        }
+        return false;
+    }
+
+    QuoteFeed::QuoteFeed(const shared_ptr<ObjectHandler::ValueObject>& properties,
+                         const shared_ptr<QuoteSource>& source,
+                         long sliceMilliseconds,
+                         bool permanent)
+    : ObjectHandler::Object(properties, permanent), source_(source),
+      slice_(boost::posix_time::milliseconds(sliceMilliseconds)),
+      running_(false), stopping_(false),
+      ticks_(0), batches_(0), applied_(0), rejected_(0),
+      lastBatch_(0), maxBatch_(0),
+      totalLatency_(0.0), maxLatency_(0.0) {
+        QL_REQUIRE(sliceMilliseconds > 0,
+                   "time slice (" << sliceMilliseconds <<
+                   " ms) must be positive");
+    }
+
+    QuoteFeed::~QuoteFeed() {
+        try {
+            stop();
+        } catch (...) {}
+    }
+
+    void QuoteFeed::start() {
+        if (thread_) {
+            if (running())
+                return;
+            thread_->join();
+        }
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            running_ = true;
+            stopping_ = false;
+            error_.clear();
+            started_ = now();
+        }
+        thread_.reset(new boost::thread(boost::bind(&QuoteFeed::run, this)));
+    }
+
+    void QuoteFeed::stop() {
+        if (!thread_)
+            return;
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            stopping_ = true;
+        }
+        source_->interrupt();
+        thread_->join();
+        thread_.reset();
+    }
+
+    bool QuoteFeed::running() const {
+        boost::mutex::scoped_lock lock(mutex_);
+        return running_;
+    }
+
+    void QuoteFeed::push(const vector<string>& quoteIds,
+                         const vector<Real>& values) {
+        QL_REQUIRE(quoteIds.size()==values.size(),
+                   "size mismatch between quotes (" << quoteIds.size() <<
+                   ") and values (" << values.size() << ")");
+        shared_ptr<QueueQuoteSource> source =
+            boost::dynamic_pointer_cast<QueueQuoteSource>(source_);
+        QL_REQUIRE(source, "quotes can only be pushed to an in-process feed");
+        for (Size i=0; i<quoteIds.size(); ++i)
+            source->push(quoteIds[i], values[i]);
+        apply();
+    }
+
+    void QuoteFeed::run() {
+        try {
+            vector<QuoteTick> ticks;
+            for (;;) {
+                {
+                    boost::mutex::scoped_lock lock(mutex_);
+                    if (stopping_)
+                        break;
+                }
+                ticks.clear();
+                bool more = source_->read(ticks, slice_);
+                if (!ticks.empty())
+                    queue(ticks);
+                if (!more)
+                    break;
+            }
+        } catch (std::exception& e) {
+            boost::mutex::scoped_lock lock(mutex_);
+            error_ = e.what();
+        } catch (...) {
+            boost::mutex::scoped_lock lock(mutex_);
+            error_ = "unknown error";
+        }
+        boost::mutex::scoped_lock lock(mutex_);
+        running_ = false;
+    }
+
+    void QuoteFeed::queue(const vector<QuoteTick>& ticks) {
+        // runs on the feed thread: the Repository is not touched here
+        boost::mutex::scoped_lock lock(mutex_);
+        for (Size i=0; i<ticks.size(); ++i) {
+            std::pair<Pending::iterator, bool> inserted =
+                pending_.insert(std::make_pair(ticks[i].quoteId, PendingQuote()));
+            inserted.first->second.value = ticks[i].value;
+            if (inserted.second)
+                inserted.first->second.received = ticks[i].received;
+        }
+        ticks_ += ticks.size();
+        ++batches_;
+        lastBatch_ = ticks.size();
+        maxBatch_ = std::max(maxBatch_, lastBatch_);
+    }
+
+    Size QuoteFeed::apply() {
+        Pending pending;
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            pending.swap(pending_);
+        }
+        if (pending.empty())
+            return 0;
+
+        vector<shared_ptr<SimpleQuote> > quotes;
+        vector<Real> values;
+        vector<ptime> received;
+        quotes.reserve(pending.size());
+        values.reserve(pending.size());
+        received.reserve(pending.size());
+        Size rejected = 0;
+        for (Pending::const_iterator i=pending.begin(); i!=pending.end(); ++i) {
+            shared_ptr<SimpleQuote> quote;
+            try {
+                ObjectHandler::Repository::instance().retrieveObject(
+                                                        quote, i->first);
+            } catch (std::exception&) {
+                ++rejected;
+                continue;
+            }
+            quotes.push_back(quote);
+            values.push_back(i->second.value);
+            received.push_back(i->second.received);
+        }
+        {
+            DeferredNotifications deferred;
+            for (Size i=0; i<quotes.size(); ++i)
+                quotes[i]->setValue(values[i]);
+            deferred.release();
+        }
+        ptime appliedAt = now();
+
+        Real totalLatency = 0.0, maxLatency = 0.0;
+        for (Size i=0; i<received.size(); ++i) {
+            Real latency = seconds(appliedAt - received[i]);
+            totalLatency += latency;
+            maxLatency = std::max(maxLatency, latency);
+        }
+
+        boost::mutex::scoped_lock lock(mutex_);
+        applied_ += quotes.size();
+        rejected_ += rejected;
+        totalLatency_ += totalLatency;
+        maxLatency_ = std::max(maxLatency_, maxLatency);
+        return quotes.size();
+    }
+
+    vector<vector<ObjectHandler::property_t> > QuoteFeed::statistics() const {
+        boost::mutex::scoped_lock lock(mutex_);
+        Real elapsed = started_.is_not_a_date_time() ?
+            0.0 : seconds(now() - started_);
+
+        typedef std::pair<string, ObjectHandler::property_t> Stat;
+        vector<Stat> stats;
+        stats.push_back(Stat("Running", running_));
+        stats.push_back(Stat("Ticks", long(ticks_)));
+        stats.push_back(Stat("Batches", long(batches_)));
+        stats.push_back(Stat("QuotesApplied", long(applied_)));
+        stats.push_back(Stat("QuotesRejected", long(rejected_)));
+        stats.push_back(Stat("QuotesPending", long(pending_.size())));
+        stats.push_back(Stat("LastBatchSize", long(lastBatch_)));
+        stats.push_back(Stat("MaxBatchSize", long(maxBatch_)));
+        stats.push_back(Stat("MeanBatchSize",
+                             batches_ > 0 ? Real(ticks_)/batches_ : 0.0));
+        stats.push_back(Stat("TicksPerSecond",
+                             elapsed > 0.0 ? ticks_/elapsed : 0.0));
+        stats.push_back(Stat("MeanLatency",
+                             applied_ > 0 ? totalLatency_/applied_ : 0.0));
+        stats.push_back(Stat("MaxLatency", maxLatency_));
+        stats.push_back(Stat("Error", error_));
+
+        vector<vector<ObjectHandler::property_t> > result;
+        vector<ObjectHandler::property_t> headings(2);
+        headings[0] = string("Statistic");
+        headings[1] = string("Value");
+        result.push_back(headings);
+        for (Size i=0; i<stats.size(); ++i) {
+            vector<ObjectHandler::property_t> row(2);
+            row[0] = stats[i].first;
+            row[1] = stats[i].second;
+            result.push_back(row);
+        }
+        return result;
+    }
+
+    QueueQuoteFeed::QueueQuoteFeed(
+            const shared_ptr<ObjectHandler::ValueObject>& properties,
+            long sliceMilliseconds,
+            bool permanent)
+    : QuoteFeed(properties, shared_ptr<QuoteSource>(new QueueQuoteSource),
+                sliceMilliseconds, permanent) {}
+
+    FileQuoteFeed::FileQuoteFeed(
+            const shared_ptr<ObjectHandler::ValueObject>& properties,
+            const string& fileName,
+            long sliceMilliseconds,
+            bool permanent)
+    : QuoteFeed(properties, shared_ptr<QuoteSource>(new StreamQuoteSource(fileName)),
+                sliceMilliseconds, permanent) {}
+
+}
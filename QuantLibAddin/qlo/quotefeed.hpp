@@ -0,0 +1,168 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Background ingestion of quote updates
+*/
+
+#ifndef qla_quotefeed_hpp
+#define qla_quotefeed_hpp
+
+#include <oh/object.hpp>
+#include <oh/iless.hpp>
+#include <ql/types.hpp>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace QuantLibAddin {
+
+    //! Update of a quote value received from a feed.
+    struct QuoteTick {
+        std::string quoteId;
+        QuantLib::Real value;
+        boost::posix_time::ptime received;
+    };
+
+    //! Source of the quote updates ingested by a QuoteFeed.
+    class QuoteSource {
+      public:
+        virtual ~QuoteSource() {}
+        //! Append to ticks the updates received within the given time.
+        /*! Returns false once the source is exhausted. */
+        virtual bool read(std::vector<QuoteTick>& ticks,
+                          const boost::posix_time::time_duration& slice) = 0;
+        //! Make a pending read() return as soon as possible.
+        virtual void interrupt() {}
+    };
+
+    //! In-process queue of quote updates, e.g. fed by a client thread.
+    class QueueQuoteSource : public QuoteSource {
+      public:
+        QueueQuoteSource() : closed_(false), interrupted_(false) {}
+        void push(const std::string& quoteId, QuantLib::Real value);
+        //! No more updates will be pushed.
+        void close();
+        bool read(std::vector<QuoteTick>& ticks,
+                  const boost::posix_time::time_duration& slice);
+        void interrupt();
+      private:
+        boost::mutex mutex_;
+        boost::condition_variable changed_;
+        std::vector<QuoteTick> pending_;
+        bool closed_, interrupted_;
+    };
+
+    //! Quote updates read from a file or named pipe.
+    /*! Each line holds a quote ID and a value separated by a comma or
+        blanks; empty lines and lines starting with '#' are skipped.  The
+        source is exhausted at the end of the file, or when the writer
+        closes the pipe.  Reads block on the stream, so that a feed
+        reading from a pipe only stops once a line or the end is read.
+    */
+    class StreamQuoteSource : public QuoteSource {
+      public:
+        explicit StreamQuoteSource(const std::string& fileName);
+        bool read(std::vector<QuoteTick>& ticks,
+                  const boost::posix_time::time_duration& slice);
+      private:
+        std::string fileName_;
+        std::ifstream in_;
+        QuantLib::Size line_;
+    };
+
+    //! Background thread collecting quote updates for SimpleQuote objects.
+    /*! Updates are read from the source in time slices by a background
+        thread, which only queues them: the last value of each quote wins.
+        Neither the Repository nor the QuantLib objects are thread-safe,
+        so the queued values are set on the thread calling apply(), with
+        the notifications of the observers deferred until the whole batch
+        is set.  Updates of unknown quotes are counted and dropped.
+    */
+    class QuoteFeed : public ObjectHandler::Object {
+      public:
+        ~QuoteFeed();
+        //! Start reading updates; nothing is done if already running.
+        void start();
+        //! Stop reading updates and wait for the thread to finish.
+        void stop();
+        bool running() const;
+        //! Push updates to the source, which must be an in-process queue.
+        /*! The updates queued by the feed so far are applied as well. */
+        void push(const std::vector<std::string>& quoteIds,
+                  const std::vector<QuantLib::Real>& values);
+        //! Set the queued values to the SimpleQuote objects.
+        /*! Returns the number of quotes set. */
+        QuantLib::Size apply();
+        //! Counters of the updates ingested so far, as name/value rows.
+        /*! The latency of a quote runs from the oldest update received
+            since it was last set to the time it is set again.
+        */
+        std::vector<std::vector<ObjectHandler::property_t> > statistics() const;
+      protected:
+        QuoteFeed(const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+                  const boost::shared_ptr<QuoteSource>& source,
+                  long sliceMilliseconds,
+                  bool permanent);
+      private:
+        // last value of a quote not applied yet, and receipt time of the
+        // oldest update since the last application
+        struct PendingQuote {
+            QuantLib::Real value;
+            boost::posix_time::ptime received;
+        };
+        typedef std::map<std::string, PendingQuote, ObjectHandler::my_iless> Pending;
+        void run();
+        void queue(const std::vector<QuoteTick>& ticks);
+        boost::shared_ptr<QuoteSource> source_;
+        boost::posix_time::time_duration slice_;
+        boost::scoped_ptr<boost::thread> thread_;
+        mutable boost::mutex mutex_;
+        Pending pending_;
+        bool running_, stopping_;
+        boost::posix_time::ptime started_;
+        QuantLib::Size ticks_, batches_, applied_, rejected_, lastBatch_, maxBatch_;
+        QuantLib::Real totalLatency_, maxLatency_;
+        std::string error_;
+    };
+
+    class QueueQuoteFeed : public QuoteFeed {
+      public:
+        QueueQuoteFeed(const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+                       long sliceMilliseconds,
+                       bool permanent);
+    };
+
+    class FileQuoteFeed : public QuoteFeed {
+      public:
+        FileQuoteFeed(const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+                      const std::string& fileName,
+                      long sliceMilliseconds,
+                      bool permanent);
+    };
+
+}
+
+#endif
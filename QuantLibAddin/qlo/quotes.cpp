@@ -20,6 +20,7 @@
 
 
 #include <qlo/quotes.hpp>
+#include <qlo/valueobjects/vo_quotes.hpp>
 #include <ql/quotes/compositequote.hpp>
 #include <ql/quotes/simplequote.hpp>
 #include <ql/quotes/derivedquote.hpp>
@@ -31,6 +32,8 @@
 #include <ql/quotes/lastfixingquote.hpp>
 #include <ql/experimental/risk/sensitivityanalysis.hpp>
 #include <ql/termstructures/volatility/optionlet/optionletstripper.hpp>
+#include <oh/repository.hpp>
+#include <oh/scenario.hpp>
 
 using std::vector;
 using std::pair;
@@ -236,4 +239,67 @@ namespace QuantLibAddin {
         return deltaMatrix;
     }
 
+    std::vector<std::vector<ObjectHandler::property_t> > simpleQuoteSetValues(
+        const std::vector<std::string>& quoteIds,
+        const std::vector<Real>& values) {
+
+        QL_REQUIRE(quoteIds.size()==values.size(),
+                   "size mismatch between quotes (" << quoteIds.size() <<
+                   ") and values (" << values.size() << ")");
+
+        // retrieve all quotes first, so that none is changed if one is missing
+        vector<shared_ptr<SimpleQuote> > quotes(quoteIds.size());
+        for (QuantLib::Size i=0; i<quoteIds.size(); ++i)
+            ObjectHandler::Repository::instance().retrieveObject(quotes[i], quoteIds[i]);
+
+        vector<Real> changes(quotes.size());
+        {
+            DeferredNotifications deferred;
+            for (QuantLib::Size i=0; i<quotes.size(); ++i)
+                changes[i] = quotes[i]->setValue(values[i]);
+            deferred.release();
+        }
+
+        vector<vector<ObjectHandler::property_t> > result;
+        vector<ObjectHandler::property_t> headings(2);
+        headings[0] = std::string("Quote");
+        headings[1] = std::string("Change");
+        result.push_back(headings);
+        for (QuantLib::Size i=0; i<quotes.size(); ++i) {
+            vector<ObjectHandler::property_t> row(2);
+            row[0] = quoteIds[i];
+            row[1] = changes[i];
+            result.push_back(row);
+        }
+        return result;
+    }
+
+    void overrideQuoteValue(ObjectHandler::Scenario& scenario,
+                            const std::string& quoteId,
+                            Real value) {
+        // storing the copy while bound to the scenario makes it an override
+        ObjectHandler::ScenarioBinding binding(scenario);
+        OH_GET_OBJECT(quote, quoteId, SimpleQuote)
+
+        // the copy gets its own properties holding the new value, so that
+        // it is recreated, serialized and displayed with that value
+        shared_ptr<ObjectHandler::ValueObject> properties;
+        if (shared_ptr<ObjectHandler::ValueObject> base = quote->properties()) {
+            properties = shared_ptr<ObjectHandler::ValueObject>(
+                new ValueObjects::qlSimpleQuote(base->objectId(), value,
+                                                quote->tickValue(),
+                                                quote->permanent()));
+            const std::set<std::string>& systemNames = base->getSystemPropertyNames();
+            std::set<std::string> names = base->getPropertyNames();
+            for (std::set<std::string>::const_iterator i = names.begin();
+                 i != names.end(); ++i) {
+                if (systemNames.find(*i) == systemNames.end())
+                    properties->setProperty(*i, base->getProperty(*i));
+            }
+        }
+        shared_ptr<ObjectHandler::Object> copy(new SimpleQuote(
+            properties, value, quote->tickValue(), quote->permanent()));
+        ObjectHandler::Repository::instance().storeObject(quoteId, copy, true);
+    }
+
 }
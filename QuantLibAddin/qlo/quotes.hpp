@@ -26,9 +26,14 @@
 #include <qlo/quote.hpp>
 
 #include <ql/option.hpp>
+#include <ql/patterns/observable.hpp>
 #include <ql/types.hpp>
 #include <ql/experimental/risk/sensitivityanalysis.hpp>
 
+namespace ObjectHandler {
+    class Scenario;
+}
+
 namespace QuantLib {
     class Index;
     class IborIndex;
@@ -151,6 +156,58 @@ namespace QuantLibAddin {
         return deltaVector;
     }
 
+    //! Defer the notifications of observers while in scope.
+    /*! Each observer notified in the meantime is notified once by
+        release(), which reports the errors raised by the observers.
+        Nothing is done if updates were already disabled by the caller.
+
+        If the object goes out of scope before release() is called, e.g.
+        because an exception was thrown, updates are enabled again and
+        the observers notified with any errors ignored.
+    */
+    class DeferredNotifications {
+      public:
+        DeferredNotifications()
+        : settings_(QuantLib::ObservableSettings::instance()),
+          deferring_(settings_.updatesEnabled()) {
+            if (deferring_)
+                settings_.disableUpdates(true);
+        }
+        ~DeferredNotifications() {
+            try {
+                release();
+            } catch (...) {}
+        }
+        //! enable updates and notify the deferred observers
+        void release() {
+            if (deferring_) {
+                deferring_ = false;
+                settings_.enableUpdates();
+            }
+        }
+      private:
+        DeferredNotifications(const DeferredNotifications&);
+        DeferredNotifications& operator=(const DeferredNotifications&);
+        QuantLib::ObservableSettings& settings_;
+        bool deferring_;
+    };
+
+    // Set the values of the given SimpleQuote objects, deferring the
+    // notifications of their observers until all values are set so that
+    // each observer is notified once.  Returns the change of each quote.
+    std::vector<std::vector<ObjectHandler::property_t> > simpleQuoteSetValues(
+        const std::vector<std::string>& quoteIds,
+        const std::vector<QuantLib::Real>& values);
+
+    //! Give the SimpleQuote with the given ID another value within a scenario.
+    /*! The quote is replaced, within the scenario only, by a copy holding
+        the new value, so that the objects depending on it are recreated
+        there while the quote in the Repository keeps its value.
+    */
+    void overrideQuoteValue(ObjectHandler::Scenario& scenario,
+                            const std::string& quoteId,
+                            QuantLib::Real value);
+
     std::vector<std::vector<QuantLib::Real> >
     bucketAnalysisDelta2(const std::vector<QuantLib::Handle<QuantLib::Quote> >& quotes,
                          const std::vector<QuantLib::Handle<QuantLib::Quote> >& parameters,
@@ -22,16 +22,145 @@
 #endif
 #include <qlo/randomsequencegenerator.hpp>
 
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <set>
+
 namespace QuantLibAddin {
 
-    static QuantLib::MersenneTwisterUniformRng rng_;
+    // Stream 0 uses the master seed itself, so that a single-threaded
+    // caller sees the same sequence as a MersenneTwisterUniformRng
+    // constructed with that seed.  Other streams scramble the master
+    // seed with the stream index (splitmix64 finalizer).  A null master
+    // seed keeps the QuantLib convention of a clock-based seed.
+    QuantLib::BigNatural streamSeed(QuantLib::BigNatural masterSeed,
+                                    long stream) {
+        if (masterSeed == 0 || stream == 0)
+            return masterSeed;
+        boost::uint64_t z = static_cast<boost::uint64_t>(masterSeed)
+            + static_cast<boost::uint64_t>(stream)
+                * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        QuantLib::BigNatural seed =
+            static_cast<QuantLib::BigNatural>(z & 0xffffffffUL);
+        return seed == 0 ? 1 : seed;
+    }
+
+    namespace {
+
+        boost::recursive_mutex masterMutex_;
+        QuantLib::BigNatural masterSeed_ = 0;
+        boost::atomic<unsigned long> generation_(0);
+        // streams of the live threads bound explicitly by randomStream(),
+        // streams bound explicitly since the last call to randomize(), and
+        // streams handed out since then; none is handed out again
+        std::multiset<long> boundStreams_;
+        std::set<long> usedBoundStreams_;
+        std::set<long> allocatedStreams_;
+        long nextStream_ = 0;
+
+        // generator owned by one thread, tagged with the generation of
+        // the master seed it was derived from
+        struct ThreadRng {
+            ThreadRng(unsigned long generation, long stream, bool bound)
+            : generation(generation), stream(stream), bound(bound),
+              rng(streamSeed(masterSeed_, stream)) {}
+            ~ThreadRng() {
+                // also runs when the owning thread exits
+                if (bound) {
+                    boost::recursive_mutex::scoped_lock lock(masterMutex_);
+                    boundStreams_.erase(boundStreams_.find(stream));
+                }
+            }
+            unsigned long generation;
+            long stream;
+            bool bound;
+            QuantLib::MersenneTwisterUniformRng rng;
+        };
+
+        boost::thread_specific_ptr<ThreadRng> threadRng_;
+
+        // first stream neither bound nor handed out; requires the lock
+        long allocateStream() {
+            while (usedBoundStreams_.count(nextStream_) ||
+                   allocatedStreams_.count(nextStream_))
+                ++nextStream_;
+            allocatedStreams_.insert(nextStream_);
+            return nextStream_++;
+        }
+
+        // requires the lock
+        void bindStream(long stream, bool bound) {
+            if (bound) {
+                boundStreams_.insert(stream);
+                usedBoundStreams_.insert(stream);
+            }
+            threadRng_.reset(new ThreadRng(generation_.load(), stream, bound));
+        }
+
+        // the calling thread's generator, (re)seeded on first use and
+        // after any call to randomize(); threads bound explicitly keep
+        // their stream
+        QuantLib::MersenneTwisterUniformRng& threadRng() {
+            ThreadRng* current = threadRng_.get();
+            if (!current ||
+                current->generation != generation_.load(boost::memory_order_acquire)) {
+                boost::recursive_mutex::scoped_lock lock(masterMutex_);
+                if (current && current->bound)
+                    bindStream(current->stream, true);
+                else
+                    bindStream(allocateStream(), false);
+                current = threadRng_.get();
+            }
+            return current->rng;
+        }
+
+    }
 
     QuantLib::Real rand() {
-        return rng_.next().value;
+        return threadRng().next().value;
+    }
+
+    std::vector<QuantLib::Real> randVector(long size) {
+        QL_REQUIRE(size >= 0, "invalid size: " << size);
+        QuantLib::MersenneTwisterUniformRng& rng = threadRng();
+        std::vector<QuantLib::Real> rtn(size);
+        for (long i=0; i<size; ++i)
+            rtn[i] = rng.nextReal();
+        return rtn;
     }
 
     void randomize(QuantLib::BigNatural seed) {
-        rng_ = QuantLib::MersenneTwisterUniformRng(seed);
+        boost::recursive_mutex::scoped_lock lock(masterMutex_);
+        masterSeed_ = seed;
+        generation_.fetch_add(1, boost::memory_order_release);
+        allocatedStreams_.clear();
+        usedBoundStreams_ = std::set<long>(boundStreams_.begin(), boundStreams_.end());
+        nextStream_ = 0;
+        ThreadRng* current = threadRng_.get();
+        if (current && current->bound)
+            bindStream(current->stream, true);
+        else
+            bindStream(allocateStream(), false);
+    }
+
+    void randomStream(long stream) {
+        QL_REQUIRE(stream >= 0, "invalid stream index: " << stream);
+        boost::recursive_mutex::scoped_lock lock(masterMutex_);
+        ThreadRng* current = threadRng_.get();
+        bool own = current && !current->bound && current->stream == stream &&
+            current->generation == generation_.load();
+        QL_REQUIRE(own || !allocatedStreams_.count(stream),
+                   "stream " << stream << " is already used by another "
+                   "thread; bind streams before drawing or after randomize()");
+        if (own)
+            allocatedStreams_.erase(stream);
+        bindStream(stream, true);
     }
 
     std::vector<std::vector<double> >
@@ -34,8 +34,29 @@
 namespace QuantLibAddin {
 
 
+    /*! qlRand() and related functions draw from a generator owned by the
+        calling thread.  Once randomize() has set a master seed, each thread
+        is bound to a stream whose seed is derived from the master seed and
+        the stream index, so that results are reproducible and threads never
+        contend for the same state.
+
+        Streams are handed out in order on a thread's first draw, the
+        thread calling randomize() getting the first.  Streams bound
+        explicitly with randomStream() are skipped, and the threads bound
+        to them keep their stream, reseeded, when randomize() is called.
+    */
     QuantLib::Real rand();
+    std::vector<QuantLib::Real> randVector(long size);
     void randomize(QuantLib::BigNatural seed);
+    //! bind the calling thread to the given stream of the master seed
+    /*! The stream is not handed out to other threads until randomize()
+        is called after the thread is bound to another one or exits.
+        Binding fails if the stream was already handed out to
+        another thread since the last call to randomize().
+    */
+    void randomStream(long stream);
+    //! seed of the given stream of the master seed
+    QuantLib::BigNatural streamSeed(QuantLib::BigNatural masterSeed, long stream);
 
     class RandomSequenceGenerator : public ObjectHandler::Object {
       public:
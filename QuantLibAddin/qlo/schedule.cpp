@@ -23,10 +23,115 @@
     #include <qlo/config.hpp>
 #endif
 #include <ql/time/schedule.hpp>
+#include <ql/settings.hpp>
 #include <qlo/schedule.hpp>
+#include <qlo/calendarcache.hpp>
+
+#include <boost/functional/hash.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <algorithm>
 
 namespace QuantLibAddin {
 
+    namespace {
+
+        // Arguments of a rule-based schedule generation.  The calendar is
+        // identified by name, and the count of holiday changes made through
+        // the addin tells apart schedules generated before and after them.
+        // Without an effective date the schedule is generated back from
+        // the evaluation date, which is then part of the key as well.
+        struct ScheduleKey {
+            QuantLib::BigInteger effectiveDate, terminationDate;
+            QuantLib::BigInteger evaluationDate;
+            QuantLib::BigInteger firstDate, nextToLastDate;
+            QuantLib::Integer tenorLength;
+            QuantLib::TimeUnit tenorUnits;
+            std::string calendar;
+            QuantLib::Size holidayChanges;
+            QuantLib::BusinessDayConvention convention, terminationDateConvention;
+            QuantLib::DateGeneration::Rule rule;
+            bool endOfMonth;
+            bool operator==(const ScheduleKey& other) const {
+                return effectiveDate == other.effectiveDate
+                    && terminationDate == other.terminationDate
+                    && evaluationDate == other.evaluationDate
+                    && firstDate == other.firstDate
+                    && nextToLastDate == other.nextToLastDate
+                    && tenorLength == other.tenorLength
+                    && tenorUnits == other.tenorUnits
+                    && calendar == other.calendar
+                    && holidayChanges == other.holidayChanges
+                    && convention == other.convention
+                    && terminationDateConvention == other.terminationDateConvention
+                    && rule == other.rule
+                    && endOfMonth == other.endOfMonth;
+            }
+        };
+
+        std::size_t hash_value(const ScheduleKey& key) {
+            std::size_t seed = 0;
+            boost::hash_combine(seed, key.effectiveDate);
+            boost::hash_combine(seed, key.terminationDate);
+            boost::hash_combine(seed, key.evaluationDate);
+            boost::hash_combine(seed, key.firstDate);
+            boost::hash_combine(seed, key.nextToLastDate);
+            boost::hash_combine(seed, key.tenorLength);
+            boost::hash_combine(seed, static_cast<int>(key.tenorUnits));
+            boost::hash_combine(seed, key.calendar);
+            boost::hash_combine(seed, key.holidayChanges);
+            boost::hash_combine(seed, static_cast<int>(key.convention));
+            boost::hash_combine(seed, static_cast<int>(key.terminationDateConvention));
+            boost::hash_combine(seed, static_cast<int>(key.rule));
+            boost::hash_combine(seed, key.endOfMonth);
+            return seed;
+        }
+
+        // QuantLib::Schedule can't be modified once built, so that
+        // schedules generated from the same arguments can share one
+        // instance.  Entries don't keep schedules alive; expired ones are
+        // purged whenever the table has doubled since the last purge.
+        class ScheduleCache {
+          public:
+            static ScheduleCache& instance() {
+                static ScheduleCache cache;
+                return cache;
+            }
+            boost::shared_ptr<QuantLib::Schedule> find(const ScheduleKey& key) {
+                boost::mutex::scoped_lock lock(mutex_);
+                Schedules::const_iterator i = schedules_.find(key);
+                if (i == schedules_.end())
+                    return boost::shared_ptr<QuantLib::Schedule>();
+                return i->second.lock();
+            }
+            void insert(const ScheduleKey& key,
+                        const boost::shared_ptr<QuantLib::Schedule>& schedule) {
+                boost::mutex::scoped_lock lock(mutex_);
+                schedules_[key] = schedule;
+                if (schedules_.size() > 2*purgedSize_) {
+                    for (Schedules::iterator i = schedules_.begin();
+                         i != schedules_.end(); ) {
+                        if (i->second.expired())
+                            i = schedules_.erase(i);
+                        else
+                            ++i;
+                    }
+                    purgedSize_ = std::max<QuantLib::Size>(schedules_.size(), 64);
+                }
+            }
+          private:
+            ScheduleCache() : purgedSize_(64) {}
+            typedef boost::unordered_map<ScheduleKey,
+                                         boost::weak_ptr<QuantLib::Schedule> > Schedules;
+            boost::mutex mutex_;
+            Schedules schedules_;
+            QuantLib::Size purgedSize_;
+        };
+
+    }
+
     Schedule::Schedule(const boost::shared_ptr<ObjectHandler::ValueObject>& p,
                        const QuantLib::Date& effectiveDate,
                        const QuantLib::Date& terminationDate,
@@ -40,18 +145,38 @@ namespace QuantLibAddin {
                        const QuantLib::Date& nextToLastDate,
                        bool permanent)
     : ObjectHandler::LibraryObject<QuantLib::Schedule>(p, permanent) {
-    
-        libraryObject_ = boost::shared_ptr<QuantLib::Schedule>(new
-            QuantLib::Schedule(effectiveDate,
-                               terminationDate,
-                               tenor,
-                               calendar,
-                               convention,
-                               terminationDateConv,
-                               rule,
-                               endOfMonth,
-                               firstDate,
-                               nextToLastDate));
+
+        ScheduleKey key;
+        key.effectiveDate = effectiveDate.serialNumber();
+        key.terminationDate = terminationDate.serialNumber();
+        key.evaluationDate = effectiveDate == QuantLib::Date() ?
+            QuantLib::Settings::instance().evaluationDate().serialNumber() : 0;
+        key.firstDate = firstDate.serialNumber();
+        key.nextToLastDate = nextToLastDate.serialNumber();
+        key.tenorLength = tenor.length();
+        key.tenorUnits = tenor.units();
+        key.calendar = calendar.empty() ? std::string() : calendar.name();
+        key.holidayChanges = CalendarCache::instance().holidayChanges();
+        key.convention = convention;
+        key.terminationDateConvention = terminationDateConv;
+        key.rule = rule;
+        key.endOfMonth = endOfMonth;
+
+        libraryObject_ = ScheduleCache::instance().find(key);
+        if (!libraryObject_) {
+            libraryObject_ = boost::shared_ptr<QuantLib::Schedule>(new
+                QuantLib::Schedule(effectiveDate,
+                                   terminationDate,
+                                   tenor,
+                                   calendar,
+                                   convention,
+                                   terminationDateConv,
+                                   rule,
+                                   endOfMonth,
+                                   firstDate,
+                                   nextToLastDate));
+            ScheduleCache::instance().insert(key, libraryObject_);
+        }
     }
 
     Schedule::Schedule(const boost::shared_ptr<ObjectHandler::ValueObject>& p,
@@ -25,25 +25,81 @@
 #include <qlo/conversions/varianttodate.hpp>
 #include <qlo/extrapolator.hpp>
 #include <qlo/baseinstruments.hpp>
+#include <qlo/calibrationhelpers.hpp>
 #include <qlo/index.hpp>
 
 namespace QuantLibAddin {
 
+    DefaultProcessor::DefaultProcessor() {
+        processors_.push_back(ObjectHandler::ProcessorPtr(new InstrumentProcessor()));
+        processors_.push_back(ObjectHandler::ProcessorPtr(new LegProcessor()));
+        processors_.push_back(ObjectHandler::ProcessorPtr(new ExtrapolatorProcessor()));
+    }
+
+    std::string DefaultProcessor::process(const ObjectHandler::SerializationFactory& factory,
+        const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
+        bool overwriteExisting) const {
+
+        return factory.restoreObject(valueObject, overwriteExisting).first;
+    }
+
+    std::set<std::string> DefaultProcessor::memberPrecedents(
+        const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject) const {
+
+        std::set<std::string> ids;
+        for (std::size_t i=0; i<processors_.size(); ++i) {
+            std::set<std::string> members = processors_[i]->memberPrecedents(valueObject);
+            ids.insert(members.begin(), members.end());
+        }
+        return ids;
+    }
+
+    void DefaultProcessor::restore(
+        const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
+        const boost::shared_ptr<ObjectHandler::Object> &object) const {
+
+        for (std::size_t i=0; i<processors_.size(); ++i)
+            processors_[i]->restore(valueObject, object);
+    }
+
     std::string InstrumentProcessor::process(const ObjectHandler::SerializationFactory& factory,
         const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
         bool overwriteExisting) const {
         
         ObjectHandler::StrObjectPair object = factory.restoreObject(valueObject, overwriteExisting);
+        restore(valueObject, object.second);
+        return object.first;
+    }
+
+    std::set<std::string> InstrumentProcessor::memberPrecedents(
+        const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject) const {
+
+        std::set<std::string> ids;
+        if (valueObject->hasProperty("EngineID"))
+            ids.insert(ObjectHandler::convert2<std::string>(
+                valueObject->getProperty("EngineID"), "EngineID"));
+        return ids;
+    }
+
+    void InstrumentProcessor::restore(
+        const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
+        const boost::shared_ptr<ObjectHandler::Object> &object) const {
+
+        if (!valueObject->hasProperty("EngineID"))
+            return;
         boost::shared_ptr<Instrument> instrument =
-            boost::dynamic_pointer_cast<Instrument>(object.second);
-        if (instrument && valueObject->hasProperty("EngineID")) {
+            boost::dynamic_pointer_cast<Instrument>(object);
+        boost::shared_ptr<BlackCalibrationHelper> helper =
+            boost::dynamic_pointer_cast<BlackCalibrationHelper>(object);
+        if (instrument || helper) {
             std::string pricingEngineID = ObjectHandler::convert2<std::string>(
                 valueObject->getProperty("EngineID"), "EngineID");
             OH_GET_OBJECT(pricingEngineObjPtr, pricingEngineID, QuantLibAddin::PricingEngine)
-            instrument->setPricingEngine(pricingEngineObjPtr);
+            if (instrument)
+                instrument->setPricingEngine(pricingEngineObjPtr);
+            else
+                helper->setPricingEngine(pricingEngineObjPtr);
         }
-                
-        return object.first;
     }
 
     std::string RelinkableHandleProcessor::process(const ObjectHandler::SerializationFactory& factory,
@@ -75,7 +131,27 @@ namespace QuantLibAddin {
         bool overwriteExisting) const {
         
         ObjectHandler::StrObjectPair object = factory.restoreObject(valueObject, overwriteExisting);
-        boost::shared_ptr<Leg> inst = boost::dynamic_pointer_cast<Leg>(object.second);
+        restore(valueObject, object.second);
+        return object.first;
+    }
+
+    std::set<std::string> LegProcessor::memberPrecedents(
+        const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject) const {
+
+        std::set<std::string> ids;
+        if (valueObject->hasProperty("UserLegIDs")) {
+            std::vector<std::string> pricers =
+                ObjectHandler::vector::convert2<std::string>(valueObject->getProperty("UserLegIDs"), "UserLegIDs");
+            ids.insert(pricers.begin(), pricers.end());
+        }
+        return ids;
+    }
+
+    void LegProcessor::restore(
+        const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
+        const boost::shared_ptr<ObjectHandler::Object> &object) const {
+
+        boost::shared_ptr<Leg> inst = boost::dynamic_pointer_cast<Leg>(object);
         if (inst && valueObject->hasProperty("UserLegIDs")) {
             std::vector<boost::shared_ptr<QuantLibAddin::FloatingRateCouponPricer> > legs2;
             std::vector<std::string> legs =
@@ -86,8 +162,6 @@ namespace QuantLibAddin {
             }
             inst->setCouponPricers(legs2);
         }
-                
-        return object.first;
     }
 
     std::string IndexProcessor::process(const ObjectHandler::SerializationFactory& factory,
@@ -117,15 +191,21 @@ namespace QuantLibAddin {
         const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
         bool overwriteExisting) const {
         ObjectHandler::StrObjectPair object = factory.restoreObject(valueObject, overwriteExisting);
+        restore(valueObject, object.second);
+        return object.first;
+    }
+
+    void ExtrapolatorProcessor::restore(
+        const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
+        const boost::shared_ptr<ObjectHandler::Object> &object) const {
+
         boost::shared_ptr<Extrapolator> extrapolator =
-            boost::dynamic_pointer_cast<Extrapolator>(object.second);
+            boost::dynamic_pointer_cast<Extrapolator>(object);
         if (extrapolator && valueObject->hasProperty("UserExtrapolation")) {
             bool extrapolation = ObjectHandler::convert2<bool>(
                 valueObject->getProperty("UserExtrapolation"), "UserExtrapolation");
             extrapolator->enableExtrapolation(extrapolation);
         }
-                
-        return object.first;
     }
 
 }
@@ -21,9 +21,36 @@
 
 #include <oh/repository.hpp>
 #include <oh/processor.hpp>
+#include <vector>
 
 namespace QuantLibAddin {
 
+    //! Processor of the Objects which have none of their own.
+    /*! Deserialization only creates the Object, as the ObjectHandler default
+        does.  Objects recreated within a Scenario also get back the pricing
+        engine, coupon pricers or extrapolation set on them after
+        construction, whatever their class.
+    */
+    class DefaultProcessor : public ObjectHandler::Processor {
+    public:
+        DefaultProcessor();
+
+    private:
+        std::string process(const ObjectHandler::SerializationFactory& factory,
+            const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
+            bool overwriteExisting) const;
+
+        void postProcess() const {}
+
+        std::set<std::string> memberPrecedents(
+            const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject) const;
+
+        void restore(const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
+            const boost::shared_ptr<ObjectHandler::Object> &object) const;
+
+        std::vector<ObjectHandler::ProcessorPtr> processors_;
+    };
+
     class InstrumentProcessor : public ObjectHandler::Processor {
 
         std::string process(const ObjectHandler::SerializationFactory& factory,
@@ -31,6 +58,12 @@ namespace QuantLibAddin {
             bool overwriteExisting) const;
 
         void postProcess() const {}
+
+        std::set<std::string> memberPrecedents(
+            const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject) const;
+
+        void restore(const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
+            const boost::shared_ptr<ObjectHandler::Object> &object) const;
     };
 
     class RelinkableHandleProcessor : public ObjectHandler::Processor {
@@ -52,6 +85,12 @@ namespace QuantLibAddin {
             bool overwriteExisting) const;
 
         void postProcess() const {}
+
+        std::set<std::string> memberPrecedents(
+            const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject) const;
+
+        void restore(const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
+            const boost::shared_ptr<ObjectHandler::Object> &object) const;
     };
 
     class IndexProcessor : public ObjectHandler::Processor {
@@ -70,6 +109,9 @@ namespace QuantLibAddin {
             bool overwriteExisting) const;
 
         void postProcess() const {}
+
+        void restore(const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
+            const boost::shared_ptr<ObjectHandler::Object> &object) const;
     };
 
 }
@@ -32,6 +32,13 @@ namespace QuantLibAddin {
 
         registerCreators();
 
+        // replaces the ObjectHandler default, for Scenarios to restore the
+        // state set after construction
+        ObjectHandler::ProcessorPtr defaultProcessor(
+            new DefaultProcessor());
+        ObjectHandler::ProcessorFactory::instance().storeProcessor(
+			"DefaultProcessor", defaultProcessor);
+
 		ObjectHandler::ProcessorPtr relinkableHandleProcessor(
             new RelinkableHandleProcessor());
         ObjectHandler::ProcessorFactory::instance().storeProcessor(
@@ -0,0 +1,228 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <qlo/config.hpp>
+#endif
+#include <qlo/sessions.hpp>
+
+#include <ql/errors.hpp>
+
+namespace QuantLibAddin {
+
+    namespace {
+
+        const std::string separator = "::";
+
+        bool startsWith(const std::string& s, const std::string& prefix) {
+            return s.size() >= prefix.size() &&
+                s.compare(0, prefix.size(), prefix) == 0;
+        }
+
+    }
+
+    Sessions& Sessions::instance() {
+        static Sessions sessions;
+        return sessions;
+    }
+
+    void Sessions::bind(QuantLib::Integer sessionId) {
+        #ifndef QL_ENABLE_SESSIONS
+        QL_REQUIRE(sessionId == 0,
+                   "cannot bind to session " << sessionId <<
+                   ": QuantLib was not compiled with QL_ENABLE_SESSIONS, "
+                   "so all threads share the same evaluation date");
+        #endif
+        if (sessionId == 0)
+            current_.reset();
+        else if (current_.get())
+            *current_ = sessionId;
+        else
+            current_.reset(new QuantLib::Integer(sessionId));
+    }
+
+    void Sessions::release() {
+        current_.reset();
+    }
+
+    QuantLib::Integer Sessions::current() const {
+        QuantLib::Integer* sessionId = current_.get();
+        return sessionId ? *sessionId : 0;
+    }
+
+    void Sessions::setNamespace(QuantLib::Integer sessionId,
+                                const std::string& name) {
+        QL_REQUIRE(name.find(separator) == std::string::npos,
+                   "namespace '" << name << "' cannot contain '" << separator << "'");
+        boost::mutex::scoped_lock lock(mutex_);
+        if (name.empty())
+            namespaces_.erase(sessionId);
+        else
+            namespaces_[sessionId] = name;
+    }
+
+    std::string Sessions::currentNamespace() const {
+        QuantLib::Integer sessionId = current();
+        boost::mutex::scoped_lock lock(mutex_);
+        std::map<QuantLib::Integer, std::string>::const_iterator i =
+            namespaces_.find(sessionId);
+        return i != namespaces_.end() ? i->second : std::string();
+    }
+
+    std::string Sessions::qualify(const std::string& objectId) const {
+        if (startsWith(objectId, separator))
+            return objectId.substr(separator.size());
+        std::string name = currentNamespace();
+        if (name.empty() || startsWith(objectId, name + separator))
+            return objectId;
+        return name + separator + objectId;
+    }
+
+    std::string SessionRepository::storeObject(
+                const std::string& objectID,
+                const boost::shared_ptr<ObjectHandler::Object>& object,
+                bool overwrite,
+                boost::shared_ptr<ObjectHandler::ValueObject> valueObject) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        return ObjectHandler::Repository::storeObject(formatID(objectID), object,
+                                                      overwrite, valueObject);
+    }
+
+    boost::shared_ptr<ObjectHandler::Object> SessionRepository::retrieveObjectImpl(
+                                                    const std::string& objectID) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        return ObjectHandler::Repository::retrieveObjectImpl(objectID);
+    }
+
+    void* SessionRepository::retrieveCachedObject(
+                const std::string& objectID,
+                const std::type_info& type,
+                boost::shared_ptr<ObjectHandler::Object>& object) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        return ObjectHandler::Repository::retrieveCachedObject(objectID, type, object);
+    }
+
+    void SessionRepository::cacheObject(
+                const std::string& objectID,
+                const std::type_info& type,
+                const boost::shared_ptr<ObjectHandler::Object>& object,
+                void* typed) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        ObjectHandler::Repository::cacheObject(objectID, type, object, typed);
+    }
+
+    void SessionRepository::deleteObject(const std::string& objectID) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        ObjectHandler::Repository::deleteObject(objectID);
+    }
+
+    void SessionRepository::deleteObject(const std::vector<std::string>& objectIDs) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        ObjectHandler::Repository::deleteObject(objectIDs);
+    }
+
+    void SessionRepository::deleteAllObjects(const bool& deletePermanent) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        ObjectHandler::Repository::deleteAllObjects(deletePermanent);
+    }
+
+    void SessionRepository::dumpObject(const std::string& objectID,
+                                       std::ostream& out) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        ObjectHandler::Repository::dumpObject(objectID, out);
+    }
+
+    void SessionRepository::dump(std::ostream& out) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        ObjectHandler::Repository::dump(out);
+    }
+
+    int SessionRepository::objectCount() {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        return ObjectHandler::Repository::objectCount();
+    }
+
+    const std::vector<std::string> SessionRepository::listObjectIDs(
+                                                const std::string& regex) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        return ObjectHandler::Repository::listObjectIDs(regex);
+    }
+
+    std::vector<bool> SessionRepository::objectExists(
+                                const std::vector<std::string>& objectList) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        return ObjectHandler::Repository::objectExists(objectList);
+    }
+
+    bool SessionRepository::objectExists(const std::string& objectID) const {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        return ObjectHandler::Repository::objectExists(objectID);
+    }
+
+    const std::vector<std::string> SessionRepository::precedentIDs(
+                                                const std::string& objectID) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        return ObjectHandler::Repository::precedentIDs(objectID);
+    }
+
+    const std::vector<std::string> SessionRepository::precedentIDs(
+                        const boost::shared_ptr<ObjectHandler::Group>& group) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        return ObjectHandler::Repository::precedentIDs(group);
+    }
+
+    std::vector<double> SessionRepository::creationTime(
+                                const std::vector<std::string>& objectList) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        return ObjectHandler::Repository::creationTime(objectList);
+    }
+
+    std::vector<double> SessionRepository::updateTime(
+                                const std::vector<std::string>& objectList) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        return ObjectHandler::Repository::updateTime(objectList);
+    }
+
+    std::vector<bool> SessionRepository::isPermanent(
+                                const std::vector<std::string>& objectList) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        return ObjectHandler::Repository::isPermanent(objectList);
+    }
+
+    const std::vector<std::string> SessionRepository::className(
+                                const std::vector<std::string>& objectList) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        return ObjectHandler::Repository::className(objectList);
+    }
+
+    const boost::shared_ptr<ObjectHandler::ObjectWrapper>&
+    SessionRepository::getObjectWrapper(const std::string& objectID) const {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        return ObjectHandler::Repository::getObjectWrapper(objectID);
+    }
+
+    void SessionRepository::registerObserver(
+                    boost::shared_ptr<ObjectHandler::ObjectWrapper> objWrapper) {
+        boost::recursive_mutex::scoped_lock lock(mutex_);
+        ObjectHandler::Repository::registerObserver(objWrapper);
+    }
+
+    std::string SessionRepository::formatID(const std::string& objectID) {
+        return Sessions::instance().qualify(objectID);
+    }
+
+}
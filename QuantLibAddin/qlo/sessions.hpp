@@ -0,0 +1,153 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Per-thread evaluation sessions for multi-threaded clients
+*/
+
+#ifndef qla_sessions_hpp
+#define qla_sessions_hpp
+
+#include <ql/types.hpp>
+#include <oh/repository.hpp>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <map>
+#include <string>
+
+namespace QuantLibAddin {
+
+    //! Sessions to which client threads bind themselves.
+    /*! When QuantLib is compiled with QL_ENABLE_SESSIONS, each session
+        has its own instance of every QuantLib singleton, and in particular
+        its own evaluation date; threads bound to different sessions can
+        then value the same trades as of different dates concurrently.
+        Session 0, to which unbound threads belong, is the one used by
+        single-threaded clients.
+
+        A session can also be given a namespace, which SessionRepository
+        prepends to the IDs of the objects created and retrieved by its
+        threads.
+    */
+    class Sessions {
+      public:
+        static Sessions& instance();
+
+        //! Bind the calling thread to the given session.
+        /*! Binding to any session but 0 requires QL_ENABLE_SESSIONS. */
+        void bind(QuantLib::Integer sessionId);
+        //! Bind the calling thread back to session 0.
+        void release();
+        //! Session the calling thread is bound to.
+        QuantLib::Integer current() const;
+
+        //! Set the namespace of the given session; empty for none.
+        void setNamespace(QuantLib::Integer sessionId, const std::string& name);
+        //! Namespace of the session the calling thread is bound to.
+        std::string currentNamespace() const;
+        //! Qualify an object ID with the namespace of the current session.
+        /*! IDs already qualified are returned unchanged; IDs starting with
+            "::" refer to objects outside any namespace.
+        */
+        std::string qualify(const std::string& objectId) const;
+
+      private:
+        Sessions() {}
+        boost::thread_specific_ptr<QuantLib::Integer> current_;
+        mutable boost::mutex mutex_;
+        std::map<QuantLib::Integer, std::string> namespaces_;
+    };
+
+    //! Bind the calling thread to a session for the lifetime of this object.
+    class SessionBinding {
+      public:
+        explicit SessionBinding(QuantLib::Integer sessionId)
+        : previous_(Sessions::instance().current()) {
+            Sessions::instance().bind(sessionId);
+        }
+        ~SessionBinding() {
+            Sessions::instance().bind(previous_);
+        }
+      private:
+        SessionBinding(const SessionBinding&);
+        SessionBinding& operator=(const SessionBinding&);
+        QuantLib::Integer previous_;
+    };
+
+    //! Repository qualifying object IDs with the namespace of the current session.
+    /*! Every call into the Repository is serialized, so that threads bound
+        to different sessions can share it.  The lock only covers the
+        Repository itself:
+
+        - objects are shared between sessions.  An object retrieved by one
+          thread can be used by another while it is being valued, and
+          whoever calls into the object must not modify it concurrently;
+        - when a dirty object is recreated on retrieval, its precedent IDs
+          are qualified with the namespace of the retrieving thread, which
+          need not be the namespace of the thread that created it.  Objects
+          meant to be retrieved from several namespaces should refer to
+          their precedents with fully qualified IDs;
+        - the reference returned by getObjectWrapper() is only valid as
+          long as no other thread deletes or overwrites the object.
+    */
+    class SessionRepository : public ObjectHandler::Repository {
+      public:
+        std::string storeObject(const std::string& objectID,
+                                const boost::shared_ptr<ObjectHandler::Object>& object,
+                                bool overwrite = false,
+                                boost::shared_ptr<ObjectHandler::ValueObject> valueObject =
+                                    boost::shared_ptr<ObjectHandler::ValueObject>());
+        boost::shared_ptr<ObjectHandler::Object> retrieveObjectImpl(
+                                                    const std::string& objectID);
+        void deleteObject(const std::string& objectID);
+        void deleteObject(const std::vector<std::string>& objectIDs);
+        void deleteAllObjects(const bool& deletePermanent = false);
+        void dumpObject(const std::string& objectID, std::ostream& out);
+        void dump(std::ostream& out);
+        int objectCount();
+        const std::vector<std::string> listObjectIDs(const std::string& regex = "");
+        std::vector<bool> objectExists(const std::vector<std::string>& objectList);
+        const std::vector<std::string> precedentIDs(const std::string& objectID);
+        std::vector<double> creationTime(const std::vector<std::string>& objectList);
+        std::vector<double> updateTime(const std::vector<std::string>& objectList);
+        std::vector<bool> isPermanent(const std::vector<std::string>& objectList);
+        const std::vector<std::string> className(const std::vector<std::string>& objectList);
+      protected:
+        const boost::shared_ptr<ObjectHandler::ObjectWrapper>& getObjectWrapper(
+                                            const std::string& objectID) const;
+        void registerObserver(boost::shared_ptr<ObjectHandler::ObjectWrapper> objWrapper);
+        std::string formatID(const std::string& objectID);
+        bool objectExists(const std::string& objectID) const;
+        const std::vector<std::string> precedentIDs(
+                            const boost::shared_ptr<ObjectHandler::Group>& group);
+        void* retrieveCachedObject(const std::string& objectID,
+                                   const std::type_info& type,
+                                   boost::shared_ptr<ObjectHandler::Object>& object);
+        void cacheObject(const std::string& objectID,
+                         const std::type_info& type,
+                         const boost::shared_ptr<ObjectHandler::Object>& object,
+                         void* typed);
+      private:
+        mutable boost::recursive_mutex mutex_;
+    };
+
+}
+
+#endif
@@ -23,10 +23,23 @@
 #endif
 
 #include <qlo/shortratemodels.hpp>
+#include <qlo/calibrationhelpers.hpp>
+#include <qlo/parallel.hpp>
+
+#include <oh/conversions/convert2.hpp>
 
 #include <ql/models/shortrate/onefactormodels/vasicek.hpp>
 #include <ql/models/shortrate/onefactormodels/hullwhite.hpp>
 #include <ql/models/shortrate/twofactormodels/g2.hpp>
+#include <ql/models/calibrationhelper.hpp>
+#include <ql/math/optimization/method.hpp>
+#include <ql/math/optimization/problem.hpp>
+#include <ql/math/optimization/projectedconstraint.hpp>
+#include <ql/math/optimization/projectedcostfunction.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
 
 namespace QuantLibAddin {
 
@@ -91,5 +104,186 @@ namespace QuantLibAddin {
             QuantLib::G2(termStructure, a, sigma, b, eta, rho));
     }
 
-}
+    namespace {
+
+        // Prices the helpers of one group, i.e. sharing a pricing engine
+        // whose arguments and results can't be used by two helpers at once.
+        class HelperGroupErrors {
+          public:
+            HelperGroupErrors(
+                const std::vector<boost::shared_ptr<QuantLib::BlackCalibrationHelper> >& helpers,
+                const std::vector<std::vector<QuantLib::Size> >& groups,
+                std::vector<QuantLib::Real>& errors)
+            : helpers_(helpers), groups_(groups), errors_(errors) {}
+            void operator()(QuantLib::Size g) {
+                for (QuantLib::Size k=0; k<groups_[g].size(); ++k) {
+                    QuantLib::Size i = groups_[g][k];
+                    errors_[i] = helpers_[i]->calibrationError();
+                }
+            }
+          private:
+            const std::vector<boost::shared_ptr<QuantLib::BlackCalibrationHelper> >& helpers_;
+            const std::vector<std::vector<QuantLib::Size> >& groups_;
+            std::vector<QuantLib::Real>& errors_;
+        };
+
+        // Same cost as QuantLib::CalibratedModel::calibrate, with the
+        // groups of helpers priced concurrently.  The first evaluation runs
+        // on the calling thread so that lazy objects shared by the helpers
+        // (curves, quotes) are calculated before any concurrent access.
+        class ParallelCalibrationFunction : public QuantLib::CostFunction {
+          public:
+            ParallelCalibrationFunction(
+                const boost::shared_ptr<QuantLib::CalibratedModel>& model,
+                const std::vector<boost::shared_ptr<QuantLib::BlackCalibrationHelper> >& helpers,
+                const std::vector<std::vector<QuantLib::Size> >& groups,
+                const std::vector<QuantLib::Real>& weights,
+                QuantLib::Size threads)
+            : model_(model), helpers_(helpers), groups_(groups),
+              weights_(weights), threads_(threads), warmedUp_(false) {}
+            QuantLib::Real value(const QuantLib::Array& params) const {
+                QuantLib::Array errors = values(params);
+                return std::sqrt(QuantLib::DotProduct(errors, errors));
+            }
+            QuantLib::Disposable<QuantLib::Array> values(
+                                    const QuantLib::Array& params) const {
+                model_->setParams(params);
+                std::vector<QuantLib::Real> errors(helpers_.size());
+                HelperGroupErrors f(helpers_, groups_, errors);
+                parallelFor(groups_.size(), warmedUp_ ? threads_ : 1, f);
+                warmedUp_ = true;
+                QuantLib::Array values(helpers_.size());
+                for (QuantLib::Size i=0; i<helpers_.size(); ++i)
+                    values[i] = errors[i] * std::sqrt(weights_[i]);
+                return values;
+            }
+          private:
+            boost::shared_ptr<QuantLib::CalibratedModel> model_;
+            const std::vector<boost::shared_ptr<QuantLib::BlackCalibrationHelper> >& helpers_;
+            const std::vector<std::vector<QuantLib::Size> >& groups_;
+            const std::vector<QuantLib::Real>& weights_;
+            QuantLib::Size threads_;
+            mutable bool warmedUp_;
+        };
+
+    }
+
+    std::vector<std::vector<ObjectHandler::property_t> > calibrateAffineModel(
+        const boost::shared_ptr<QuantLib::AffineModel>& model,
+        const std::vector<boost::shared_ptr<BlackCalibrationHelper> >& helperObjects,
+        const boost::shared_ptr<QuantLib::OptimizationMethod>& method,
+        const QuantLib::EndCriteria& endCriteria,
+        const std::vector<std::vector<QuantLib::Real> >& startingPoints,
+        const std::vector<QuantLib::Real>& weights,
+        const std::vector<bool>& fixParameters,
+        QuantLib::Size threads) {
+
+        boost::shared_ptr<QuantLib::CalibratedModel> calibratedModel =
+            boost::dynamic_pointer_cast<QuantLib::CalibratedModel>(model);
+        QL_REQUIRE(calibratedModel, "model is not calibrated");
+        QL_REQUIRE(!helperObjects.empty(), "no calibration helpers given");
+        QL_REQUIRE(weights.empty() || weights.size() == helperObjects.size(),
+                   "mismatch between number of helpers (" << helperObjects.size()
+                   << ") and weights (" << weights.size() << ")");
+
+        QuantLib::Array initial = calibratedModel->params();
+        QL_REQUIRE(fixParameters.empty() || fixParameters.size() == initial.size(),
+                   "mismatch between number of model parameters ("
+                   << initial.size() << ") and fixed-parameter flags ("
+                   << fixParameters.size() << ")");
+        std::vector<bool> fixed = fixParameters;
+        if (fixed.empty())
+            fixed.resize(initial.size(), false);
+        QL_REQUIRE(std::find(fixed.begin(), fixed.end(), false) != fixed.end(),
+                   "all model parameters are fixed");
+
+        std::vector<std::vector<QuantLib::Real> > starts = startingPoints;
+        if (starts.empty())
+            starts.push_back(std::vector<QuantLib::Real>(initial.begin(),
+                                                         initial.end()));
+        std::vector<QuantLib::Real> w = weights;
+        if (w.empty())
+            w.resize(helperObjects.size(), 1.0);
 
+        // helpers sharing a pricing engine, as recorded by
+        // qlCalibrationHelperSetPricingEngine, are priced in turn
+        std::vector<boost::shared_ptr<QuantLib::BlackCalibrationHelper> >
+            helpers(helperObjects.size());
+        std::vector<std::vector<std::string> > engines(helperObjects.size());
+        for (QuantLib::Size i=0; i<helperObjects.size(); ++i) {
+            helperObjects[i]->getLibraryObject(helpers[i]);
+            boost::shared_ptr<ObjectHandler::ValueObject> properties =
+                helperObjects[i]->properties();
+            if (properties->hasProperty("EngineID"))
+                engines[i].push_back(ObjectHandler::convert2<std::string>(
+                    properties->getProperty("EngineID"), "EngineID"));
+        }
+        std::vector<std::vector<QuantLib::Size> > groups =
+            groupBySharedKeys(engines);
+
+        ParallelCalibrationFunction f(calibratedModel, helpers, groups, w, threads);
+        QuantLib::Constraint constraint = calibratedModel->constraint();
+
+        std::vector<std::vector<ObjectHandler::property_t> > result;
+        QuantLib::Size numberOfColumns = 5 + initial.size();
+        std::vector<ObjectHandler::property_t> headings(numberOfColumns);
+        headings[0] = std::string("Start");
+        headings[1] = std::string("End Criteria");
+        headings[2] = std::string("Cost");
+        headings[3] = std::string("Evaluations");
+        headings[4] = std::string("Elapsed");
+        for (QuantLib::Size j=0; j<initial.size(); ++j) {
+            std::ostringstream name;
+            name << "Param " << j;
+            headings[5+j] = name.str();
+        }
+        result.push_back(headings);
+
+        QuantLib::Real bestCost = QuantLib::QL_MAX_REAL;
+        QuantLib::Array best = initial;
+        for (QuantLib::Size i=0; i<starts.size(); ++i) {
+            QL_REQUIRE(starts[i].size() == initial.size(),
+                       "starting point " << i << " has " << starts[i].size()
+                       << " parameters, " << initial.size() << " required");
+            QuantLib::Array start(starts[i].begin(), starts[i].end());
+            QL_REQUIRE(constraint.test(start),
+                       "starting point " << i << " violates the model constraint");
+
+            // as in CalibratedModel::calibrate, fixed parameters keep the
+            // value of the starting point and only the others are optimized
+            WallTimer timer;
+            QuantLib::Projection projection(start, fixed);
+            QuantLib::ProjectedCostFunction projectedCost(f, projection);
+            QuantLib::ProjectedConstraint projectedConstraint(constraint,
+                                                              projection);
+            QuantLib::Problem problem(projectedCost, projectedConstraint,
+                                      projection.project(start));
+            QuantLib::EndCriteria::Type endType =
+                method->minimize(problem, endCriteria);
+            QuantLib::Real elapsed = timer.elapsed();
+
+            QuantLib::Array fit = projection.include(problem.currentValue());
+            QuantLib::Real cost = f.value(fit);
+            if (cost < bestCost) {
+                bestCost = cost;
+                best = fit;
+            }
+
+            std::vector<ObjectHandler::property_t> row(numberOfColumns);
+            row[0] = static_cast<long>(i);
+            std::ostringstream endCriteriaType;
+            endCriteriaType << endType;
+            row[1] = endCriteriaType.str();
+            row[2] = cost;
+            row[3] = static_cast<long>(problem.functionEvaluation());
+            row[4] = elapsed;
+            for (QuantLib::Size j=0; j<fit.size(); ++j)
+                row[5+j] = fit[j];
+            result.push_back(row);
+        }
+
+        calibratedModel->setParams(best);
+        return result;
+    }
+
+}
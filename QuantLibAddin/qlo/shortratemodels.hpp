@@ -24,14 +24,20 @@
 #include <qlo/termstructures.hpp>
 #include <qlo/models.hpp>
 
+#include <oh/property.hpp>
+
 #include <ql/types.hpp>
 
+#include <vector>
+
 namespace QuantLib {
     template <class T>
     class Handle;
 
     class AffineModel;
     class OneFactorAffineModel;
+    class OptimizationMethod;
+    class EndCriteria;
 
 }
 
@@ -89,6 +95,29 @@ namespace QuantLibAddin {
            QuantLib::Real rho,
            bool permanent);
     };
+
+    class BlackCalibrationHelper;
+
+    //! Multi-start calibration of an affine model to a set of helpers.
+    /*! Each row of startingPoints is used in turn as the initial guess of
+        the optimization; an empty matrix means a single run from the
+        current model parameters.  Parameters flagged in fixParameters keep
+        the value of the starting point, as in CalibratedModel::calibrate.
+        Within each cost-function evaluation the helpers are priced on up
+        to the given number of threads (0 meaning one per hardware thread);
+        helpers sharing a pricing engine are priced in turn on one thread.
+        The model is left at the best fit found, and one row of diagnostics
+        is returned per starting point.
+    */
+    std::vector<std::vector<ObjectHandler::property_t> > calibrateAffineModel(
+        const boost::shared_ptr<QuantLib::AffineModel>& model,
+        const std::vector<boost::shared_ptr<BlackCalibrationHelper> >& helpers,
+        const boost::shared_ptr<QuantLib::OptimizationMethod>& method,
+        const QuantLib::EndCriteria& endCriteria,
+        const std::vector<std::vector<QuantLib::Real> >& startingPoints,
+        const std::vector<QuantLib::Real>& weights,
+        const std::vector<bool>& fixParameters,
+        QuantLib::Size threads);
 }
 
 #endif
@@ -24,6 +24,7 @@
 #endif
 
 #include <qlo/smilesection.hpp>
+#include <qlo/parallel.hpp>
 
 #include <ql/termstructures/volatility/interpolatedsmilesection.hpp>
 #include <ql/termstructures/volatility/sabrinterpolatedsmilesection.hpp>
@@ -32,6 +33,9 @@
 #include <ql/termstructures/volatility/flatsmilesection.hpp>
 #include <ql/quotes/simplequote.hpp>
 
+#include <set>
+#include <sstream>
+
 namespace QuantLibAddin {
 
     FlatSmileSection::FlatSmileSection(
@@ -216,5 +220,152 @@ namespace QuantLibAddin {
            
              libraryObject_ = sabrVol->smileSection(time,true);  
     }
-}
 
+    namespace {
+
+        struct SabrFit {
+            SabrFit() : alpha(0.0), beta(0.0), nu(0.0), rho(0.0),
+                        rmsError(0.0), maxError(0.0), elapsed(0.0) {}
+            QuantLib::Real alpha, beta, nu, rho;
+            QuantLib::Real rmsError, maxError;
+            std::string endCriteria;
+            QuantLib::Real elapsed;
+            std::string error;
+        };
+
+        // Fits the sections of one group in turn; distinct groups share no
+        // quote, end criteria or optimization method and can be processed
+        // concurrently.
+        class SabrGroupFit {
+          public:
+            SabrGroupFit(
+                const std::vector<boost::shared_ptr<QuantLib::SabrInterpolatedSmileSection> >& sections,
+                const std::vector<std::vector<QuantLib::Size> >& groups,
+                std::vector<SabrFit>& fits)
+            : sections_(sections), groups_(groups), fits_(fits) {}
+            void operator()(QuantLib::Size g) {
+                for (QuantLib::Size k=0; k<groups_[g].size(); ++k) {
+                    QuantLib::Size i = groups_[g][k];
+                    SabrFit& fit = fits_[i];
+                    WallTimer timer;
+                    try {
+                        fit.alpha = sections_[i]->alpha();
+                        fit.beta = sections_[i]->beta();
+                        fit.nu = sections_[i]->nu();
+                        fit.rho = sections_[i]->rho();
+                        fit.rmsError = sections_[i]->rmsError();
+                        fit.maxError = sections_[i]->maxError();
+                        std::ostringstream endCriteria;
+                        endCriteria << sections_[i]->endCriteria();
+                        fit.endCriteria = endCriteria.str();
+                    } catch (std::exception& e) {
+                        fit.error = e.what();
+                    }
+                    fit.elapsed = timer.elapsed();
+                }
+            }
+          private:
+            const std::vector<boost::shared_ptr<QuantLib::SabrInterpolatedSmileSection> >& sections_;
+            const std::vector<std::vector<QuantLib::Size> >& groups_;
+            std::vector<SabrFit>& fits_;
+        };
+
+        // Collects the object IDs held by a property, i.e. its strings.
+        class PropertyIds : public boost::static_visitor<> {
+          public:
+            explicit PropertyIds(std::vector<std::string>& ids) : ids_(ids) {}
+            void operator()(const std::string& id) const {
+                ids_.push_back(id);
+            }
+            void operator()(const ObjectHandler::property_t::vector& v) const {
+                for (QuantLib::Size i=0; i<v.size(); ++i)
+                    boost::apply_visitor(*this, v[i]);
+            }
+            template <class T>
+            void operator()(const T&) const {}
+          private:
+            std::vector<std::string>& ids_;
+        };
+
+    }
+
+    std::vector<std::vector<ObjectHandler::property_t> > fitSabrSmileSections(
+        const std::vector<boost::shared_ptr<SmileSection> >& sections,
+        QuantLib::Size threads) {
+
+        QL_REQUIRE(!sections.empty(), "no smile sections given");
+
+        // Quotes, end criteria and methods given as values rather than IDs
+        // are private to each section; those given as IDs may be shared.
+        static const char* inputs[] = { "ForwardRate", "AtmVolatility",
+                                        "VolatilitySpreads", "EndCriteria",
+                                        "Method" };
+        std::vector<boost::shared_ptr<QuantLib::SabrInterpolatedSmileSection> >
+                                                    sabrSections(sections.size());
+        std::vector<std::vector<std::string> > shared(sections.size());
+        for (QuantLib::Size i=0; i<sections.size(); ++i) {
+            sections[i]->getLibraryObject(sabrSections[i]);
+            std::set<std::string> names = sections[i]->propertyNames();
+            PropertyIds ids(shared[i]);
+            for (QuantLib::Size j=0; j<sizeof(inputs)/sizeof(inputs[0]); ++j) {
+                if (names.find(inputs[j]) != names.end()) {
+                    ObjectHandler::property_t value =
+                        sections[i]->propertyValue(inputs[j]);
+                    boost::apply_visitor(ids, value);
+                }
+            }
+        }
+        std::vector<std::vector<QuantLib::Size> > groups =
+            groupBySharedKeys(shared);
+
+        // Sections in different groups may still depend on the same lazy
+        // objects further up, e.g. quotes implied from a common curve:
+        // those are calculated here, so that the worker threads only read
+        // them.  The sections themselves are fitted by the workers.
+        std::set<const ObjectHandler::Object*> reached;
+        for (QuantLib::Size i=0; i<sections.size(); ++i)
+            collectPrecedents(sections[i]->properties()->objectId(), reached);
+        for (std::set<const ObjectHandler::Object*>::const_iterator
+                 i=reached.begin(); i!=reached.end(); ++i)
+            calculateLazyObject(*i);
+
+        std::vector<SabrFit> fits(sections.size());
+        SabrGroupFit f(sabrSections, groups, fits);
+        parallelFor(groups.size(), threads, f);
+
+        std::vector<std::vector<ObjectHandler::property_t> > result;
+        std::vector<ObjectHandler::property_t> headings(10);
+        headings[0] = std::string("Section");
+        headings[1] = std::string("Alpha");
+        headings[2] = std::string("Beta");
+        headings[3] = std::string("Nu");
+        headings[4] = std::string("Rho");
+        headings[5] = std::string("RMS Error");
+        headings[6] = std::string("Max Error");
+        headings[7] = std::string("End Criteria");
+        headings[8] = std::string("Elapsed");
+        headings[9] = std::string("Error");
+        result.push_back(headings);
+
+        for (QuantLib::Size i=0; i<sections.size(); ++i) {
+            const SabrFit& fit = fits[i];
+            std::vector<ObjectHandler::property_t> row(10, std::string("N/A"));
+            row[0] = sections[i]->properties()->objectId();
+            row[8] = fit.elapsed;
+            if (fit.error.empty()) {
+                row[1] = fit.alpha;
+                row[2] = fit.beta;
+                row[3] = fit.nu;
+                row[4] = fit.rho;
+                row[5] = fit.rmsError;
+                row[6] = fit.maxError;
+                row[7] = fit.endCriteria;
+                row[9] = std::string();
+            } else {
+                row[9] = fit.error;
+            }
+            result.push_back(row);
+        }
+        return result;
+    }
+}
@@ -22,9 +22,12 @@
 #define qla_smilesection_hpp
 
 #include <oh/libraryobject.hpp>
+#include <oh/property.hpp>
 #include <ql/types.hpp>
 #include <ql/termstructures/volatility/volatilitytype.hpp>
 
+#include <vector>
+
 
 namespace QuantLib {
     class Date;
@@ -150,6 +153,21 @@ namespace QuantLibAddin {
             const QuantLib::Time& time,
             bool permanent);
     };
+
+    //! Fit the SABR parameters of a set of independent smile sections.
+    /*! Sections are fitted concurrently on up to the given number of
+        threads (0 meaning one per hardware thread), except that sections
+        sharing an input object (forward or volatility quotes, end criteria
+        or optimization method) are fitted one after the other on a single
+        thread, since quotes may be lazily calculated and optimization
+        methods keep mutable state.  Lazy term structures and quotes on
+        which the sections depend, directly or not, are calculated on the
+        calling thread beforehand.  Returns one row of diagnostics,
+        including the elapsed wall-clock time, per section.
+    */
+    std::vector<std::vector<ObjectHandler::property_t> > fitSabrSmileSections(
+        const std::vector<boost::shared_ptr<SmileSection> >& sections,
+        QuantLib::Size threads);
 }
 
 #endif
@@ -0,0 +1,162 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+// Checks that the number of threads bootstrapping the daily curves of a
+// HistoricalForwardRatesAnalysis does not change its results: the analysis
+// is run serially and with several threads on the same synthetic fixings,
+// and the statistics and the skipped and failed dates are compared.
+
+#include <Addins/Cpp/init.hpp>
+#include <qlo/correlation.hpp>
+#include <oh/ohdefines.hpp>
+#if defined BOOST_MSVC
+#include <oh/auto_link.hpp>
+#endif
+#include <ql/indexes/ibor/euribor.hpp>
+#include <ql/indexes/swap/euriborswap.hpp>
+#include <ql/math/statistics/sequencestatistics.hpp>
+#include <ql/models/marketmodels/historicalforwardratesanalysis.hpp>
+#include <ql/settings.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <cmath>
+#include <iostream>
+
+using namespace QuantLib;
+
+namespace {
+
+    // fixings depending smoothly on the date, with an upward sloping curve
+    void addFixings(const Date& startDate, const Date& endDate,
+                    const boost::shared_ptr<IborIndex>& ibor,
+                    const std::vector<boost::shared_ptr<SwapIndex> >& swaps) {
+        Calendar calendar = ibor->fixingCalendar();
+        for (Date d=startDate; d<=endDate; ++d) {
+            if (!calendar.isBusinessDay(d))
+                continue;
+            Real t = (d - startDate)/365.0;
+            Rate level = 0.02 + 0.005*std::sin(6.0*t) + 0.002*t;
+            ibor->addFixing(d, level);
+            for (Size i=0; i<swaps.size(); ++i) {
+                Real years = swaps[i]->tenor().length();
+                swaps[i]->addFixing(d, level + 0.001*years*(1.0 + 0.2*std::cos(4.0*t)));
+            }
+        }
+    }
+
+    boost::shared_ptr<SequenceStatistics> analysis(
+                const Date& startDate, const Date& endDate,
+                const boost::shared_ptr<IborIndex>& ibor,
+                const std::vector<boost::shared_ptr<SwapIndex> >& swaps,
+                Size threads,
+                boost::shared_ptr<HistoricalForwardRatesAnalysis>& result) {
+        boost::shared_ptr<SequenceStatistics> stats(new SequenceStatistics);
+        std::vector<boost::shared_ptr<IborIndex> > ibors(1, ibor);
+        QuantLibAddin::HistoricalForwardRatesAnalysis analysis(
+            boost::shared_ptr<ObjectHandler::ValueObject>(),
+            stats, startDate, endDate, 1*Weeks, ibor, 6*Months, 5*Years,
+            ibors, swaps, Actual365Fixed(), "Discount", "LogLinear", 1.0e-12,
+            threads, false);
+        analysis.getLibraryObject(result);
+        return stats;
+    }
+
+    bool check(const std::string& what, Real serial, Real parallel,
+               Real tolerance) {
+        if (std::fabs(serial - parallel) <= tolerance)
+            return true;
+        std::cout << what << ": " << serial << " with one thread, "
+                  << parallel << " with several" << std::endl;
+        return false;
+    }
+
+}
+
+int main() {
+
+    try {
+
+        QuantLibAddinCpp::initializeAddin();
+
+        Date startDate(2, January, 2018), endDate(31, December, 2018);
+        Settings::instance().evaluationDate() = endDate;
+
+        boost::shared_ptr<IborIndex> ibor(new Euribor6M);
+        std::vector<boost::shared_ptr<SwapIndex> > swaps;
+        swaps.push_back(boost::shared_ptr<SwapIndex>(new EuriborSwapIsdaFixA(2*Years)));
+        swaps.push_back(boost::shared_ptr<SwapIndex>(new EuriborSwapIsdaFixA(5*Years)));
+        swaps.push_back(boost::shared_ptr<SwapIndex>(new EuriborSwapIsdaFixA(10*Years)));
+        addFixings(startDate, endDate, ibor, swaps);
+        // a missing fixing makes one date skipped in both analyses
+        ibor->clearFixings();
+        addFixings(startDate, Date(15, May, 2018), ibor,
+                   std::vector<boost::shared_ptr<SwapIndex> >());
+        addFixings(Date(17, May, 2018), endDate, ibor,
+                   std::vector<boost::shared_ptr<SwapIndex> >());
+
+        boost::shared_ptr<HistoricalForwardRatesAnalysis> serial, parallel;
+        boost::shared_ptr<SequenceStatistics> serialStats =
+            analysis(startDate, endDate, ibor, swaps, 1, serial);
+        boost::shared_ptr<SequenceStatistics> parallelStats =
+            analysis(startDate, endDate, ibor, swaps, 4, parallel);
+
+        bool ok = true;
+        ok = ok && check("samples", serialStats->samples(),
+                         parallelStats->samples(), 0.0);
+        ok = ok && check("skipped dates", serial->skippedDates().size(),
+                         parallel->skippedDates().size(), 0.0);
+        ok = ok && check("failed dates", serial->failedDates().size(),
+                         parallel->failedDates().size(), 0.0);
+        for (Size i=0; ok && i<serial->skippedDates().size(); ++i)
+            ok = check("skipped date", serial->skippedDates()[i].serialNumber(),
+                       parallel->skippedDates()[i].serialNumber(), 0.0);
+        for (Size i=0; ok && i<serial->failedDates().size(); ++i)
+            ok = check("failed date", serial->failedDates()[i].serialNumber(),
+                       parallel->failedDates()[i].serialNumber(), 0.0);
+
+        // the serial bootstrap starts from the curve of the previous date,
+        // so the relative forward rate changes agree within a few times
+        // the bootstrap accuracy divided by the rates
+        if (ok) {
+            std::vector<Real> serialMean = serialStats->mean(),
+                              parallelMean = parallelStats->mean();
+            Matrix serialCovariance = serialStats->covariance(),
+                   parallelCovariance = parallelStats->covariance();
+            for (Size i=0; i<serialMean.size(); ++i) {
+                ok = check("mean", serialMean[i], parallelMean[i], 1.0e-8) && ok;
+                for (Size j=0; j<serialMean.size(); ++j)
+                    ok = check("covariance", serialCovariance[i][j],
+                               parallelCovariance[i][j], 1.0e-10) && ok;
+            }
+        }
+
+        if (!ok) {
+            std::cout << "thread count changes the historical forward rates analysis"
+                      << std::endl;
+            return 1;
+        }
+        return 0;
+
+    } catch (const std::exception &e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cout << "Unknown error" << std::endl;
+        return 1;
+    }
+
+}
+
@@ -0,0 +1,148 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+// Checks that an IncrementalBootstrap gives the same curve as a full
+// bootstrap when a helper quote and the exogenous discount curve used by
+// the swap helpers move together: the pillars before the moved quote must
+// be solved again, while those of the deposits are kept.
+
+#include <Addins/Cpp/init.hpp>
+#include <qlo/incrementalbootstrap.hpp>
+#include <oh/ohdefines.hpp>
+#if defined BOOST_MSVC
+#include <oh/auto_link.hpp>
+#endif
+#include <ql/indexes/ibor/euribor.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/settings.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/termstructures/yield/piecewiseyieldcurve.hpp>
+#include <ql/termstructures/yield/ratehelpers.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/daycounters/thirty360.hpp>
+#include <cmath>
+#include <iostream>
+
+using namespace QuantLib;
+
+namespace {
+
+    typedef PiecewiseYieldCurve<Discount, LogLinear,
+                                QuantLibAddin::IncrementalBootstrap>
+                                                        IncrementalCurve;
+    typedef PiecewiseYieldCurve<Discount, LogLinear> FullCurve;
+
+    // deposits first, then swaps discounted on the given curve
+    std::vector<boost::shared_ptr<RateHelper> > rateHelpers(
+                const std::vector<boost::shared_ptr<SimpleQuote> >& quotes,
+                const Handle<YieldTermStructure>& discountCurve) {
+        std::vector<boost::shared_ptr<RateHelper> > helpers;
+        helpers.push_back(boost::shared_ptr<RateHelper>(new
+            DepositRateHelper(Handle<Quote>(quotes[0]),
+                              boost::shared_ptr<IborIndex>(new Euribor3M))));
+        helpers.push_back(boost::shared_ptr<RateHelper>(new
+            DepositRateHelper(Handle<Quote>(quotes[1]),
+                              boost::shared_ptr<IborIndex>(new Euribor6M))));
+        Integer years[] = { 2, 5, 10 };
+        for (Size i=0; i<3; ++i)
+            helpers.push_back(boost::shared_ptr<RateHelper>(new
+                SwapRateHelper(Handle<Quote>(quotes[i+2]), years[i]*Years,
+                               TARGET(), Annual, Unadjusted,
+                               Thirty360(Thirty360::BondBasis),
+                               boost::shared_ptr<IborIndex>(new Euribor6M),
+                               Handle<Quote>(), 0*Days, discountCurve)));
+        return helpers;
+    }
+
+    bool check(const std::string& what, const Date& pillar,
+               Real full, Real incremental, Real tolerance) {
+        if (std::fabs(full - incremental) <= tolerance)
+            return true;
+        std::cout << what << " at " << pillar << ": " << full
+                  << " with a full bootstrap, " << incremental
+                  << " with an incremental one" << std::endl;
+        return false;
+    }
+
+}
+
+int main() {
+
+    try {
+
+        QuantLibAddinCpp::initializeAddin();
+
+        Date referenceDate(15, January, 2020);
+        Settings::instance().evaluationDate() = referenceDate;
+
+        Rate rates[] = { 0.010, 0.012, 0.015, 0.020, 0.025 };
+        std::vector<boost::shared_ptr<SimpleQuote> > quotes;
+        for (Size i=0; i<5; ++i)
+            quotes.push_back(boost::make_shared<SimpleQuote>(rates[i]));
+        RelinkableHandle<YieldTermStructure> discountCurve(
+            boost::shared_ptr<YieldTermStructure>(new
+                FlatForward(referenceDate, 0.005, Actual365Fixed())));
+
+        boost::shared_ptr<QuantLibAddin::BootstrapStatistics> statistics(
+                                    new QuantLibAddin::BootstrapStatistics);
+        IncrementalCurve incremental(
+            referenceDate, rateHelpers(quotes, discountCurve),
+            Actual365Fixed(), LogLinear(),
+            QuantLibAddin::IncrementalBootstrap<IncrementalCurve>(
+                                                        statistics, 1.0e-12));
+        incremental.discount(1.0);
+
+        // the last swap quote and the discount curve move together
+        quotes[4]->setValue(0.026);
+        discountCurve.linkTo(boost::shared_ptr<YieldTermStructure>(new
+            FlatForward(referenceDate, 0.010, Actual365Fixed())));
+
+        FullCurve full(referenceDate, rateHelpers(quotes, discountCurve),
+                       Actual365Fixed());
+
+        bool ok = true;
+        const std::vector<Date>& dates = full.dates();
+        for (Size i=1; i<dates.size(); ++i)
+            ok = check("discount", dates[i], full.discount(dates[i]),
+                       incremental.discount(dates[i]), 1.0e-10) && ok;
+
+        // the deposits do not depend on the discount curve and are kept,
+        // the swaps before the moved quote are solved again
+        if (statistics->firstPillar != 3) {
+            std::cout << "incremental bootstrap restarted at pillar "
+                      << statistics->firstPillar << " instead of 3"
+                      << std::endl;
+            ok = false;
+        }
+
+        if (!ok) {
+            std::cout << "incremental bootstrap differs from a full one"
+                      << std::endl;
+            return 1;
+        }
+        return 0;
+
+    } catch (const std::exception &e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cout << "Unknown error" << std::endl;
+        return 1;
+    }
+
+}
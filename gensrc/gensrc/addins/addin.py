@@ -57,6 +57,11 @@ class Addin(serializable.Serializable):
         """Return the buffer of code for loop functions."""
         return self.bufferLoop_
 
+    def bufferBatch(self):
+        """Return the buffer of code for the batch variants of Member
+        functions."""
+        return self.bufferBatch_
+
     def unchanged(self):
         """Return a count of the source code files for this addin
         which are unchanged for this execution of gensrc."""
@@ -94,6 +99,16 @@ class Addin(serializable.Serializable):
         from the XML rule metadata for this addin."""
         return self.libraryCall_
 
+    def objectConversions(self):
+        """Return the RuleGroup object named objectConversions which was loaded
+        from the XML rule metadata for this addin."""
+        return self.objectConversions_
+
+    def referenceConversions(self):
+        """Return the RuleGroup object named referenceConversions which was loaded
+        from the XML rule metadata for this addin."""
+        return self.referenceConversions_
+
     def libraryReturnType(self):
         """Return the RuleGroup object named libraryReturnType which was loaded
         from the XML rule metadata for this addin."""
@@ -109,6 +124,11 @@ class Addin(serializable.Serializable):
         from the XML rule metadata for this addin."""
         return self.loopReturnType_
 
+    def batchValue(self):
+        """Return the RuleGroup object named batchValue which was loaded
+        from the XML rule metadata for this addin."""
+        return self.batchValue_
+
     def idStrip(self, parameterList):
         """Return the RuleGroup object named idStrip which was loaded
         from the XML rule metadata for this addin.
@@ -67,7 +67,7 @@ class CppAddin(addin.Addin):
             self.bufferAll_.append("#include <Addins/Cpp/%s.hpp>\n" % cat.name())
             bufferCpp = ''
             bufferHpp = ''
-            for func in cat.functions(self.name_): 
+            for func in cat.functions(self.name_, batch = self.batchFunctions_): 
                 bufferCpp += self.generateFunction(func)
                 bufferHpp += self.generateDeclaration(func)
             self.bufferBody_.set({
@@ -119,4 +119,5 @@ class CppAddin(addin.Addin):
     def serialize(self, serializer):
         """Load/unload class state to/from serializer object."""
         super(CppAddin, self).serialize(serializer)
+        serializer.serializeBoolean(self, 'batchFunctions')
 
@@ -110,7 +110,7 @@ class ExcelAddin(addin.Addin):
             categoryIncludes = cat.includeList(LOOP_INCLUDES)
             self.bufferIncludes_.set({
                 'categoryIncludes' : categoryIncludes })
-            for func in cat.functions(self.name_):
+            for func in cat.functions(self.name_, batch = self.batchFunctions_):
                 self.bufferIncludes_.append(self.generateFunction(func))
             fileName = '%sfunctions/%s.cpp' % (
                 self.rootPath_, cat.name())
@@ -247,7 +247,7 @@ class ExcelAddin(addin.Addin):
         """Generate the code for registering addin functions with Excel."""
         registerCode = ''
         unregisterCode = ''
-        for func in cat.functions(self.name_, supportedplatform.MANUAL):
+        for func in cat.functions(self.name_, supportedplatform.MANUAL, self.batchFunctions_):
             self.functionCount_ += 1
             registerCode += self.generateRegisterFunction(func,
                 cat.xlFunctionWizardCategory())
@@ -284,7 +284,7 @@ class ExcelAddin(addin.Addin):
         clients of this Addin."""
         exportSymbols = ''
         for cat in self.categoryList_.categories(self.name_, self.coreCategories_, self.addinCategories_, supportedplatform.MANUAL):
-            for func in cat.functions(self.name_, supportedplatform.MANUAL):
+            for func in cat.functions(self.name_, supportedplatform.MANUAL, self.batchFunctions_):
                 #exportSymbols += '#pragma comment (linker, "/export:_%s")\n' % func.name()
                 exportSymbols += '#pragma comment (linker, "/export:" EXPORT_PREFIX "%s")\n' % func.name()
         self.exportStub_.set({'exportSymbols' : exportSymbols})
@@ -380,4 +380,5 @@ class ExcelAddin(addin.Addin):
         """Load/unload class state to/from serializer object."""
         super(ExcelAddin, self).serialize(serializer)
         serializer.serializeBoolean(self, 'exportSymbols')
+        serializer.serializeBoolean(self, 'batchFunctions')
 
@@ -36,6 +36,28 @@ class ValueObjects(addin.Addin):
     PROCESSOR_NAME = '''\
         virtual std::string processorName() { return "%(processorName)s"; }'''
 
+    PROPERTY_LENGTH = '''\
+          case %(length)d:
+%(comparisons)s            break;
+'''
+
+    PROPERTY_COMPARISON = '''\
+            if (ObjectHandler::equalsUpper(name, "%(nameUpper)s"))
+                return %(index)d;
+'''
+
+    PROPERTY_CASE = '''\
+          case %(index)d:
+%(code)s'''
+
+    # ObjectId and ClassName are held by the ValueObject base class and are
+    # indexed after the properties declared by the constructor.
+    BASE_PROPERTIES = (
+        ('ObjectId', '            return objectId_;\n',
+            '            objectId_ = boost::get<std::string>(value);\n'),
+        ('ClassName', '            return className_;\n',
+            '            className_ = boost::get<std::string>(value);\n'))
+
     #############################################
     # public interface
     #############################################
@@ -69,6 +91,55 @@ class ValueObjects(addin.Addin):
 
         log.Log.instance().logMessage(' done generating ValueObjects.')
 
+    def systemProperties(self, func):
+        """Return the parameters of the given constructor which are stored as
+        system properties of its ValueObject, in the order of their indices."""
+        return [param for param in func.parameterList().parameters()
+            if param.propertyIndex() is not None]
+
+    def generateProperties(self, func):
+        """Generate the bodies of the functions dispatching on property names
+        and indices.  Names are switched on their length and then compared,
+        without regard to case and without allocating, against the few names
+        of that length.  The indices are those of getSystemProperty(std::size_t):
+        the declared properties in order, then ObjectId and ClassName."""
+        getters = []
+        setters = []
+        names = []
+        for param in self.systemProperties(func):
+            names.append(param.name())
+            getters.append(self.propertyGet_.apply(param))
+            setters.append(self.propertySet_.apply(param) + '            break;\n')
+        for name, getter, setter in ValueObjects.BASE_PROPERTIES:
+            names.append(name)
+            getters.append(getter)
+            setters.append(setter + '            break;\n')
+
+        byLength = {}
+        for index, name in enumerate(names):
+            byLength.setdefault(len(name), []).append(ValueObjects.PROPERTY_COMPARISON % {
+                'index' : index,
+                'nameUpper' : name.upper() })
+        propertyIndex = ''
+        for length in sorted(byLength):
+            propertyIndex += ValueObjects.PROPERTY_LENGTH % {
+                'comparisons' : ''.join(byLength[length]),
+                'length' : length }
+
+        propertyGet = ''
+        propertySet = ''
+        for index in range(len(names)):
+            propertyGet += ValueObjects.PROPERTY_CASE % {
+                'code' : getters[index],
+                'index' : index }
+            propertySet += ValueObjects.PROPERTY_CASE % {
+                'code' : setters[index],
+                'index' : index }
+        return {
+            'propertyIndex' : propertyIndex,
+            'propertyGet' : propertyGet,
+            'propertySet' : propertySet }
+
     def generateHeaderInline(self, func):
         """Generate class definition source for prototype of given constructor function."""
         if func.processorName():
@@ -86,16 +157,16 @@ class ValueObjects(addin.Addin):
 
     def generateFunctionInline(self, func):
         """Generate source code for function."""
-        return self.bufferClassBodyInline_.set({
+        properties = self.generateProperties(func)
+        properties.update({
             'constructorInit' : func.parameterList().generate(self.constructorInit_),
             'constructorParList' : func.parameterList().generate(self.constructorDeclaration_),
             'functionName' : func.name(),
             'propertyDeclaration' : func.parameterList().generate(self.propertyDeclaration_),
-            'propertyGet' : func.parameterList().generate(self.propertyGet_),
-            'propertySet' : func.parameterList().generate(self.propertySet_),
             'propertyInsert' : func.parameterList().generate(self.propertyInsert_),
             'propertyPush' : func.parameterList().generate(self.propertyPush_),
             'populateObjectIDs' : func.parameterList().generate(self.populateObjectIDs_) })
+        return self.bufferClassBodyInline_.set(properties)
 
     def generateHeadersInline(self, cat):
         """Generate class source for constructor function prototypes."""
@@ -147,14 +218,14 @@ class ValueObjects(addin.Addin):
 
     def generateFunction(self, func):
         """Generate source code for function."""
-        return self.bufferClassBody_.set({
+        properties = self.generateProperties(func)
+        properties.update({
             'constructorInit' : func.parameterList().generate(self.constructorInit_),
             'constructorParList' : func.parameterList().generate(self.constructorDeclaration_),
             'functionName' : func.name(),
             'propertyDeclaration' : func.parameterList().generate(self.propertyDeclaration_),
-            'propertyGet' : func.parameterList().generate(self.propertyGet_),
-            'propertySet' : func.parameterList().generate(self.propertySet_),
             'populateObjectIDs' : func.parameterList().generate(self.populateObjectIDs_) })
+        return self.bufferClassBody_.set(properties)
 
     def generateFunctions(self, cat):
         """Generate source for function implementations."""
@@ -22,6 +22,7 @@
 
 from gensrc.utilities import common
 from gensrc.utilities import utilities
+from gensrc.categories import exceptions
 from gensrc.functions import function
 from gensrc.functions import supportedplatform
 from gensrc.serialization import serializable
@@ -46,9 +47,14 @@ class Category(serializable.Serializable):
             if func.platformSupported(platformName, implementation):
                 return True
 
-    def functions(self, platformName, implementation = supportedplatform.AUTO):
-        """Serve up functions alphabetically by name."""
-        for functionKey in self.functionKeys_: 
+    def functions(self, platformName, implementation = supportedplatform.AUTO, batch = False):
+        """Serve up functions alphabetically by name, including the batch
+        variants of Member functions if requested."""
+        if batch:
+            functionKeys = self.allFunctionKeys_
+        else:
+            functionKeys = self.functionKeys_
+        for functionKey in functionKeys: 
             func = self.functions_[functionKey]
             if platformName == '*' \
             or func.platformSupported(platformName, implementation):
@@ -115,6 +121,19 @@ class Category(serializable.Serializable):
             if func.loopParameter():
                 self.containsLoopFunction_ = True
 
+        # Derive the batch variants of the functions, which are served
+        # only to the Addins requesting them.
+        self.allFunctionKeys_ = list(self.functionKeys_)
+        for func in list(self.functions_.values()):
+            batchFunc = func.batchVariant()
+            if not batchFunc: continue
+            if batchFunc.name() in self.functions_:
+                raise exceptions.BatchNameException(
+                    self.name_, func.name(), batchFunc.name())
+            self.functions_[batchFunc.name()] = batchFunc
+            self.allFunctionKeys_.append(batchFunc.name())
+        self.allFunctionKeys_.sort()
+
     def sort_uniq(self, list):
         ret = []
         for item in list:
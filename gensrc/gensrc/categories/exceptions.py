@@ -34,3 +34,17 @@ because another category has already been defined with that name."""
         self.value_ = DuplicateNameException.DUPLICATE_NAME_ERROR % {
             'categoryName' : categoryName }
 
+
+class BatchNameException(CategoryException):
+
+    BATCH_NAME_ERROR = """
+Error processing category %(categoryName)s -
+Cannot create the batch variant of function %(functionName)s
+because another function has already been defined with name %(batchName)s."""
+
+    def __init__(self, categoryName, functionName, batchName):
+        """Initialize the BatchNameException object."""
+        self.value_ = BatchNameException.BATCH_NAME_ERROR % {
+            'batchName' : batchName,
+            'categoryName' : categoryName,
+            'functionName' : functionName }
@@ -0,0 +1,69 @@
+"""
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+"""
+
+"""Class to generate source code for the batch variant of a Member function.
+
+The first input of the batch variant is a vector of object IDs.  The other
+inputs are converted once, then the Addin function loops on the IDs,
+retrieving each object and calling the underlying member function on it.
+The results are saved in a vector of properties which is the return value of
+the Addin function.  The errors are caught object by object: the result of
+an object on which the call fails is left empty and the error is logged."""
+
+import re
+
+class BehaviorMemberBatch(object):
+    """Generate source code for a Member function which loops on a list of
+    object IDs."""
+
+    #############################################
+    # public interface
+    #############################################
+
+    def generateBody(self, addin):
+        """Generate source code for the body of the function."""
+        addin.bufferBatch().set({
+            'functionName' : self.func_.name(),
+            'libraryFunction' : self.func_.libraryFunction(),
+            'memberAccess' : self.func_.memberAccess(),
+            'objectConversions' : self.convert(addin.objectConversions()),
+            'objectId' : self.objectIdRef_.name(),
+            'objectIdConverted' : self.func_.objectId(),
+            'objectIds' : self.func_.parameterList().parameters()[0].name(),
+            'parameterList' : self.func_.parameterList().generate(addin.libraryCall()),
+            'referenceConversions' : self.convert(addin.referenceConversions()),
+            'valueConversion' : addin.batchValue().apply(self.valueRef_) })
+        return addin.bufferBatch().text()
+
+    #############################################
+    # private member functions
+    #############################################
+
+    def __init__(self, func, objectIdRef, valueRef):
+        """Save references to the function, to the ID of the object on
+        which the underlying member function is invoked and to the return
+        value of the underlying member function."""
+        self.func_ = func
+        self.objectIdRef_ = objectIdRef
+        self.valueRef_ = valueRef
+
+    def convert(self, ruleGroup):
+        """Return the code retrieving the object with the current ID, indented
+        to the body of the loop."""
+        code = ruleGroup.apply(self.objectIdRef_)
+        if code:
+            return re.sub('(?m)^(?=.)', 8 * ' ', code)
+        else:
+            return ''
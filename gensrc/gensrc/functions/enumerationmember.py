@@ -35,6 +35,15 @@ from gensrc.configuration import environment
 class EnumerationMember(member.Member):
     """Function which invokes member function of Enumeration from the Registry."""
 
+    #############################################
+    # public interface
+    #############################################
+
+    def batchVariant(self):
+        """Enumerations are retrieved one at a time from the Registry,
+        there is no batch variant."""
+        return None
+
     #############################################
     # serializer interface
     #############################################
@@ -103,6 +103,10 @@ class Function(serializable.Serializable):
     def behavior(self):
         return self.behavior_
 
+    def batchVariant(self):
+        """Return the batch variant of this function, if any."""
+        return None
+
     def printDebug(self):
         self.parameterList_.printDebug()
 
@@ -27,6 +27,8 @@ from gensrc.serialization import serializable
 from gensrc.functions import function
 from gensrc.functions import behavior
 from gensrc.functions import behaviorloop
+from gensrc.functions import behaviorbatch
+from gensrc.functions import supportedplatform
 from gensrc.parameters import parameterlist
 from gensrc.parameters import parameter
 from gensrc.configuration import environment
@@ -53,6 +55,15 @@ class Member(function.Function):
     def objectId(self):
         return self.objectId_
 
+    def batchVariant(self):
+        """Return the batch variant of this function, or None if the
+        return value can't be collected into a vector."""
+        if self.batch_ and not self.loopParameter_ \
+        and self.returnValue_.tensorRank() == common.SCALAR \
+        and self.returnValue_.fullType().nativeType() != common.VOID \
+        and self.returnValue_.fullType().superType() != common.ENUM:
+            return MemberBatch(self)
+
     #############################################
     # serializer interface
     #############################################
@@ -66,6 +77,7 @@ class Member(function.Function):
         serializer.serializeAttribute(self, common.LOOP_PARAMETER)
         serializer.serializeObject(self, parameter.ReturnValue)
         serializer.serializeAttributeBoolean(self, common.CONST, True)
+        serializer.serializeAttributeBoolean(self, 'batch', False)
 
     def postSerialize(self):
         """Perform post serialization initialization."""
@@ -85,3 +97,49 @@ class Member(function.Function):
             self.behavior_ = behaviorloop.BehaviorMemberLoop(self)
         else:
             self.behavior_ = behavior.BehaviorMember(self)
+
+class MemberBatch(Member):
+    """Batch variant of a Member function.
+
+    The batch variant takes a list of object IDs in place of the single ID,
+    invokes the member function on each of the objects in turn and returns
+    the vector of results.  The remaining inputs are converted once for the
+    whole list, and the overhead of the Addin function call is incurred once
+    rather than once per object.  An object on which the member function
+    fails gets an empty result, e.g. #N/A in Excel, and its error is logged
+    without failing the others.
+
+    Batch variants are derived from the Members with metadata attribute
+    batch='true', provided that they return a scalar and don't loop on
+    another parameter, and are named after the Member with suffix 'Batch'.
+    They are generated on the platforms which support them, if enabled in
+    the metadata of the Addin."""
+
+    #############################################
+    # class variables
+    #############################################
+
+    NAME_SUFFIX = 'Batch'
+
+    #############################################
+    # private member functions
+    #############################################
+
+    def __init__(self, func):
+        """Derive the batch variant from the given Member."""
+        self.__dict__.update(func.__dict__)
+        self.name_ = func.name() + MemberBatch.NAME_SUFFIX
+        self.description_ = func.description() + ' - batch variant'
+        self.longDescription_ = func.longDescription() + \
+            ' Batch variant, returning one value for each object in the list,' + \
+            ' or an empty value for the objects on which the function fails.'
+        self.supportedPlatforms_ = dict([ (platformName, supportedPlatform)
+            for platformName, supportedPlatform in func.supportedPlatforms_.items()
+            if supportedPlatform.implNum() == supportedplatform.AUTO ])
+
+        parameterObjectId = func.parameterList().parameters()[0]
+        self.parameterList_ = func.parameterList().replaceFirst(
+            parameter.MemberObjectIdList(self.type_, self.superType_))
+        self.returnValue_ = parameter.BatchReturnValue()
+        self.behavior_ = behaviorbatch.BehaviorMemberBatch(
+            self, parameterObjectId, func.returnValue())
@@ -38,6 +38,7 @@ class Value(serializable.Serializable):
     loop_ = ''
     vectorIterator_ = ''
     lastParameter_ = False
+    propertyIndex_ = None
     ignore_ = False
     default_ = ''
     errorValue_ = ''
@@ -99,6 +100,11 @@ class Value(serializable.Serializable):
         in the list for the given function."""
         return self.lastParameter_
 
+    def propertyIndex(self):
+        """Return the index of this parameter among the system properties of
+        the ValueObject of its function, or None if it is not one of them."""
+        return self.propertyIndex_
+
     def errorValue(self):
         """Return the value, if any, to be substituted for this parameter
         if the original value is erroneous."""
@@ -109,6 +115,11 @@ class Value(serializable.Serializable):
         in the list for the given function."""
         self.lastParameter_ = val
 
+    def setPropertyIndex(self, val):
+        """Set the index of this parameter among the system properties of
+        the ValueObject of its function."""
+        self.propertyIndex_ = val
+
     def setLoop(self, val):
         """Set the boolean value indicating whether this parameter is configured
         as the loop parameter for the function."""
@@ -190,6 +201,19 @@ class ReturnValue(Value):
         """Perform post serialization initialization."""
         self.fullType_ = environment.getType(self.type_, self.superType_)
 
+class BatchReturnValue(Value):
+    """Return value of the batch variant of a Member.
+
+    One value for each of the objects on which the Member is invoked,
+    left empty for the objects on which it fails."""
+
+    name_ = 'returnValue'
+    tensorRank_ = common.VECTOR
+
+    def __init__(self):
+        """Initialize the BatchReturnValue object."""
+        self.fullType_ = environment.getType(common.ANY)
+
 class ConstructorReturnValue(Value):
     """Class to represent state shared by the return values
     of all constructors."""
@@ -245,6 +269,23 @@ class MemberObjectId(Parameter):
         self.fullType_ = environment.getType(typeName, superTypeName)
         self.description_ = 'id of existing %s object' % self.fullType_.value()
 
+class MemberObjectIdList(Parameter):
+    """IDs of a list of objects.
+
+    Takes the place of MemberObjectId as the first input parameter
+    of the batch variant of a Member, which is invoked on each of
+    the objects in turn."""
+
+    name_ = 'ObjectIds'
+    tensorRank_ = common.VECTOR
+    ignore_ = False
+
+    def __init__(self, typeName, superTypeName):
+        """Initialize the MemberObjectIdList object."""
+        self.fullType_ = environment.getType(common.STRING)
+        self.description_ = 'list of ids of existing %s objects' % \
+            environment.getType(typeName, superTypeName).value()
+
 class EnumerationId(Parameter):
     """ID of an enumeration.
 
@@ -23,6 +23,7 @@ from gensrc.utilities import common
 from gensrc.parameters import parameter
 from gensrc.parameters import exceptions
 from gensrc.serialization import serializable
+import copy
 
 class ParameterList(serializable.Serializable):
     """The list of Parameter objects that relate to a given
@@ -63,6 +64,7 @@ class ParameterList(serializable.Serializable):
         self.parameters_.insert(0, param)
         self.parameterCount_ += 1
         self.skipFirst_ = True
+        self.numberProperties()
 
     def append(self, param):
         """Append a parameter to the list."""
@@ -71,11 +73,25 @@ class ParameterList(serializable.Serializable):
         self.parameters_.append(param)
         param.setLastParameter(True)
         self.parameterCount_ += 1
+        self.numberProperties()
+
+    def replaceFirst(self, param):
+        """Return a copy of the list in which the first parameter
+        is replaced by the given one."""
+        ret = copy.copy(self)
+        ret.parameters_ = [ param ] + self.parameters_[1:]
+        param.setLastParameter(self.parameterCount_ == 1)
+        return ret
 
     def parameters(self):
         """Return the list of parameters."""
         return self.parameters_
 
+    def skipFirst(self):
+        """Return a boolean indicating whether the first parameter was
+        prepended by the generator rather than declared in the metadata."""
+        return self.skipFirst_
+
     def underlyingCount(self):
         """Return the number of parameters that will actually
         be passed to the underlying Addin function.
@@ -88,6 +104,19 @@ class ParameterList(serializable.Serializable):
         """Return the number of parameters in the list."""
         return self.parameterCount_
 
+    def numberProperties(self):
+        """Number the parameters stored as system properties of the
+        ValueObject: all of them except the generated first one and those
+        ignored by the library, in declaration order.  The numbers are the
+        indices taken by ValueObject::getSystemProperty(std::size_t)."""
+        index = 0
+        for position, param in enumerate(self.parameters_):
+            if (position == 0 and self.skipFirst_) or param.ignore():
+                param.setPropertyIndex(None)
+            else:
+                param.setPropertyIndex(index)
+                index += 1
+
     def printDebug(self):
         """Print debug information to stdout."""
         for param in self.parameters_:
@@ -127,4 +156,5 @@ class ParameterList(serializable.Serializable):
             if i == self.parameterCount_:
                 param.setLastParameter(True)
             i += 1
+        self.numberProperties()
 
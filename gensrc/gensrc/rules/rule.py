@@ -201,6 +201,7 @@ class RuleGroup(serializable.Serializable):
             common.NAMESPACE_OBJ : environment.config().namespaceObjects(),
             common.NATIVE_TYPE : self.param_.fullType().nativeType(),
             common.OBJECT_REFERENCE : self.param_.fullType().objectReference(),
+            common.PROPERTY_INDEX : self.param_.propertyIndex(),
             common.SUPER_TYPE : self.param_.fullType().superType(),
             common.TENSOR_RANK : self.param_.tensorRank(),
             common.TYPE : self.param_.fullType().value() }
@@ -85,6 +85,7 @@ OBJECT_REFERENCE = 'objectReference'
 OTHER = 'other'
 PAD_LAST_PARAM = 'padLastParamDesc'
 PROCESSOR_NAME = 'processorName'
+PROPERTY_INDEX = 'propertyIndex'
 REFERENCE = 'reference'
 ROOT_DIRECTORY = 'rootDirectory'
 SCALAR = 'scalar'